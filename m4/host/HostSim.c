@@ -0,0 +1,684 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/**
+ * Runs the firmware on the host: the real I2S, USB, codec and logging tasks
+ * on the mock kernel, MSDK and TinyUSB, in virtual time. The codec captures a
+ * counting pattern and the mock USB host receives the stream, which is checked
+ * frame by frame for drops, duplicates, zero fill and corruption, and timed
+ * for latency. Exits non-zero if anything went wrong.
+ *
+ * Faults the target can see (late interrupts, missed polls, stalled tasks)
+ * can be switched on once the stream opens to soak the pipeline, with latency
+ * and ring occupancy still held to their bounds.
+ *
+ * Given a WAV file instead, the codec plays it from the moment the stream
+ * opens, and what the host receives is lined up against a golden file (by
+ * default the input itself, as the pipeline is bit exact at unity gain) and
+ * checked the same way. What the host received can be saved as the golden
+ * file for later runs.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "MockKernel.h"
+#include "MockMsdk.h"
+#include "MockUsb.h"
+#include "WavCompare.h"
+#include "WavFile.h"
+
+#include "AudioConfig.h"
+#include "AudioStats.h"
+#include "I2S_Task.h"
+#include "USB_Task.h"
+
+#define SIM_NS_PER_MS 1000000ULL
+#define SIM_NS_PER_SEC 1000000000ULL
+
+/* Boot, codec setup included, is done well before this */
+#define SIM_STREAM_START_NS (200 * SIM_NS_PER_MS)
+
+/* The rate loop's drift estimate is only meaningful this long after the
+ * stream opens, the same settle time TestRateControl checks against */
+#define SIM_DRIFT_SETTLE_SEC 600
+
+#define SIM_SAMPLE_MASK ((uint32_t)((1ULL << AUDIO_SAMPLE_BITS) - 1))
+#define SIM_MAX_EVENTS 20
+
+/* The firmware's main, renamed by the build */
+int FirmwareMain(void);
+
+typedef struct {
+    double seconds;
+    uint32_t rate;
+    double ppm;
+    bool fullSpeed;
+    bool console;
+    bool verbose;
+    bool bench;
+    double maxLatencyUs;
+    double driftTolerance;
+    const char *inPath;
+    const char *outPath;
+    const char *goldenPath;
+    uint32_t maxOccupancy;
+    uint32_t seed;
+    uint32_t jitterUs;
+    uint32_t missPermille;
+    uint32_t stallEveryMs;
+    uint32_t stallMaxMs;
+    uint32_t isrDelayUs;
+    uint32_t isrDelayPermille;
+} sim_options_t;
+
+/* Checks the received pattern the way tools/checkstream.py does */
+typedef struct {
+    bool locked;
+    uint32_t expected;
+    uint64_t frames;
+    uint64_t leading;
+    uint64_t zero;
+    uint64_t dropped;
+    uint64_t duplicated;
+    uint64_t corrupt;
+    uint32_t events;
+} sim_check_t;
+
+static sim_options_t opts = {
+    .seconds = 10,
+    .rate = AUDIO_SAMPLE_RATE,
+    .driftTolerance = -1,
+    .maxOccupancy = 100,
+    .seed = 1,
+    .stallMaxMs = 5,
+    .isrDelayPermille = 100,
+};
+
+static bool streaming;
+
+static sim_check_t check;
+static uint64_t latencyCount;
+static double latencyMinUs = INFINITY;
+static double latencyMaxUs;
+static double latencySumUs;
+static uint32_t occupancyMax;
+static uint32_t stalls;
+static double wallSec; /**< Host time the run took, for --bench */
+
+/* Golden file runs. The input plays from the first frame the codec captures
+ * after the stream opens */
+static wav_file_t inWav;
+static wav_writer_t outWav;
+static uint64_t streamStartFrame = UINT64_MAX;
+static int32_t *rxFrames; /**< Every frame received, when checking a file */
+static uint64_t rxCount;
+static uint64_t rxRoom;
+
+static void SimUsage(const char *prog);
+static void SimParseArgs(int argc, char **argv);
+static void SimSource(uint64_t frame, int32_t *samples, uint32_t channels, void *arg);
+static void SimSink(const uint8_t *data, uint32_t len, void *arg);
+static void SimConsole(const uint8_t *data, uint32_t len, void *arg);
+static void SimStartStream(void *arg);
+static void SimStall(void *arg);
+static void SimCheckFrame(const int32_t *samples);
+static bool SimIsPattern(const int32_t *samples);
+static int32_t SimGetSample(const uint8_t *p, uint32_t width);
+static void SimKeepFrame(const int32_t *samples);
+static bool SimCompareGolden(wav_compare_t *result);
+static int SimReport(void);
+
+int main(int argc, char **argv)
+{
+    struct timespec t0;
+    struct timespec t1;
+    int result;
+
+    SimParseArgs(argc, argv);
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    MockSeed(opts.seed);
+    if ((opts.inPath != NULL) && !WavRead(&inWav, opts.inPath)) {
+        return 2;
+    }
+    if ((inWav.data != NULL) && (inWav.rate != opts.rate)) {
+        fprintf(stderr, "%s: %u Hz, the stream runs at %u Hz\n", opts.inPath,
+                (unsigned)inWav.rate, (unsigned)opts.rate);
+    }
+    if ((opts.outPath != NULL) &&
+        !WavWriterOpen(&outWav, opts.outPath, AUDIO_NUM_CHANNELS, AUDIO_BYTES_PER_SAMPLE,
+                       opts.rate)) {
+        return 2;
+    }
+
+    MockI2sSetSource(SimSource, NULL);
+    MockI2sSetClockPpm(opts.ppm);
+    MockUsbSetSpeed(opts.fullSpeed ? TUSB_SPEED_FULL : TUSB_SPEED_HIGH);
+    MockUsbSetSink(SimSink, NULL);
+    MockUartSetSink(opts.console ? SimConsole : NULL, NULL);
+
+    MockAt(SIM_STREAM_START_NS, SimStartStream, NULL);
+    MockStopAt(SIM_STREAM_START_NS + (uint64_t)(opts.seconds * SIM_NS_PER_SEC));
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    FirmwareMain();
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    wallSec = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) / 1e9;
+    WavWriterClose(&outWav);
+    result = SimReport();
+    WavFree(&inWav);
+    free(rxFrames);
+    return result;
+}
+
+void SimUsage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --seconds S          stream for S seconds of virtual time (10)\n"
+            "  --rate HZ            sample rate the host selects (%u)\n"
+            "  --ppm P              codec clock offset from the USB clock\n"
+            "  --full-speed         enumerate at full speed\n"
+            "  --console            print the firmware's console\n"
+            "  --in FILE            capture a WAV file instead of the counting pattern\n"
+            "  --golden FILE        compare what the host receives with FILE (the input)\n"
+            "  --out FILE           write what the host received\n"
+            "  --max-latency-us N   fail if a packet is older than this\n"
+            "  --max-occupancy PCT  fail if the capture ring fills past this (100)\n"
+            "  --drift-tolerance P  fail if the settled drift estimate is further off\n"
+            "                       than this\n"
+            "  --verbose            list every stream event\n"
+            "  --bench              report throughput, and how fast the host ran it\n"
+            "Faults, from the stream start:\n"
+            "  --seed N             random seed for the faults (1)\n"
+            "  --jitter-us N        transfer complete interrupts up to N us late\n"
+            "  --miss-permille N    host skips N in 1000 polls, as lost SOFs\n"
+            "  --stall-every-ms N   stall the I2S or USB task every N ms on average\n"
+            "  --stall-max-ms N     longest stall (5)\n"
+            "  --isr-delay-us N     DMA completion interrupts up to N us late\n"
+            "  --isr-delay-permille N  share of DMA interrupts delayed (100)\n",
+            prog, (unsigned)AUDIO_SAMPLE_RATE);
+    exit(2);
+}
+
+void SimParseArgs(int argc, char **argv)
+{
+    int i;
+    const char *arg;
+    const char *val;
+
+    for (i = 1; i < argc; i++) {
+        arg = argv[i];
+        val = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--full-speed") == 0) {
+            opts.fullSpeed = true;
+            continue;
+        } else if (strcmp(arg, "--console") == 0) {
+            opts.console = true;
+            continue;
+        } else if (strcmp(arg, "--verbose") == 0) {
+            opts.verbose = true;
+            continue;
+        } else if (strcmp(arg, "--bench") == 0) {
+            opts.bench = true;
+            continue;
+        }
+        if (val == NULL) {
+            SimUsage(argv[0]);
+        }
+        i++;
+        if (strcmp(arg, "--seconds") == 0) {
+            opts.seconds = atof(val);
+        } else if (strcmp(arg, "--rate") == 0) {
+            opts.rate = (uint32_t)strtoul(val, NULL, 0);
+        } else if (strcmp(arg, "--ppm") == 0) {
+            opts.ppm = atof(val);
+        } else if (strcmp(arg, "--max-latency-us") == 0) {
+            opts.maxLatencyUs = atof(val);
+        } else if (strcmp(arg, "--max-occupancy") == 0) {
+            opts.maxOccupancy = (uint32_t)strtoul(val, NULL, 0);
+        } else if (strcmp(arg, "--seed") == 0) {
+            opts.seed = (uint32_t)strtoul(val, NULL, 0);
+        } else if (strcmp(arg, "--jitter-us") == 0) {
+            opts.jitterUs = (uint32_t)strtoul(val, NULL, 0);
+        } else if (strcmp(arg, "--miss-permille") == 0) {
+            opts.missPermille = (uint32_t)strtoul(val, NULL, 0);
+        } else if (strcmp(arg, "--stall-every-ms") == 0) {
+            opts.stallEveryMs = (uint32_t)strtoul(val, NULL, 0);
+        } else if (strcmp(arg, "--stall-max-ms") == 0) {
+            opts.stallMaxMs = (uint32_t)strtoul(val, NULL, 0);
+        } else if (strcmp(arg, "--isr-delay-us") == 0) {
+            opts.isrDelayUs = (uint32_t)strtoul(val, NULL, 0);
+        } else if (strcmp(arg, "--isr-delay-permille") == 0) {
+            opts.isrDelayPermille = (uint32_t)strtoul(val, NULL, 0);
+        } else if (strcmp(arg, "--drift-tolerance") == 0) {
+            opts.driftTolerance = atof(val);
+        } else if (strcmp(arg, "--in") == 0) {
+            opts.inPath = val;
+        } else if (strcmp(arg, "--out") == 0) {
+            opts.outPath = val;
+        } else if (strcmp(arg, "--golden") == 0) {
+            opts.goldenPath = val;
+        } else {
+            SimUsage(argv[0]);
+        }
+    }
+    if ((opts.seconds <= 0) || ((opts.goldenPath != NULL) && (opts.inPath == NULL)) ||
+        (opts.seed == 0)) {
+        SimUsage(argv[0]);
+    }
+}
+
+/**
+ * Codec input, the counting pattern AUDIO_TEST_PATTERN puts out on the
+ * target: each frame's number on the first channel, its complement on the
+ * second. A WAV file plays from the stream start, with silence either side
+ */
+void SimSource(uint64_t frame, int32_t *samples, uint32_t channels, void *arg)
+{
+    uint32_t ch;
+
+    (void)arg;
+    if (inWav.data == NULL) {
+        samples[0] = (int32_t)((uint32_t)frame & SIM_SAMPLE_MASK);
+        if (channels > 1) {
+            samples[1] = (int32_t)(~(uint32_t)frame & SIM_SAMPLE_MASK);
+        }
+        return;
+    }
+    for (ch = 0; ch < channels; ch++) {
+        samples[ch] = 0;
+        if ((frame >= streamStartFrame) && ((frame - streamStartFrame) < inWav.frames)) {
+            samples[ch] = WavSample(&inWav, (uint32_t)(frame - streamStartFrame), ch,
+                                    AUDIO_SAMPLE_BITS);
+        }
+    }
+}
+
+/**
+ * Host side of the stream, once per poll. Checks and times what arrived
+ */
+void SimSink(const uint8_t *data, uint32_t len, void *arg)
+{
+    int32_t samples[AUDIO_NUM_CHANNELS];
+    uint32_t occupancy;
+    uint32_t frame;
+    uint32_t ch;
+    uint64_t pos;
+    uint64_t captured;
+    double latencyUs;
+    bool first = true;
+
+    (void)arg;
+    occupancy = I2S_TaskBytesAvailable() / AUDIO_FRAME_BYTES;
+    if (occupancy > occupancyMax) {
+        occupancyMax = occupancy;
+    }
+    if (!streaming || (len == 0)) {
+        return;
+    }
+    if (outWav.file != NULL) {
+        WavWriterWrite(&outWav, data, len);
+    }
+    for (frame = 0; frame < len / AUDIO_FRAME_BYTES; frame++) {
+        for (ch = 0; ch < AUDIO_NUM_CHANNELS; ch++) {
+            samples[ch] = SimGetSample(&data[(frame * AUDIO_NUM_CHANNELS + ch) *
+                                             AUDIO_BYTES_PER_SAMPLE],
+                                       AUDIO_BYTES_PER_SAMPLE);
+        }
+        if (inWav.data != NULL) {
+            //Checked against the golden file once the run is over
+            SimKeepFrame(samples);
+            continue;
+        }
+        SimCheckFrame(samples);
+        if (first && check.locked && SimIsPattern(samples)) {
+            //The oldest frame in the packet. The pattern only holds the low
+            //bits of its number, the codec's position gives the rest
+            first = false;
+            pos = (uint64_t)MockI2sFramePos();
+            captured = pos - ((pos - (uint32_t)samples[0]) & SIM_SAMPLE_MASK);
+            latencyUs = ((MockI2sFramePos() - (double)captured) * 1e6) / MockI2sFrameRate();
+            latencyCount++;
+            latencySumUs += latencyUs;
+            if (latencyUs < latencyMinUs) {
+                latencyMinUs = latencyUs;
+            }
+            if (latencyUs > latencyMaxUs) {
+                latencyMaxUs = latencyUs;
+            }
+        }
+    }
+}
+
+void SimCheckFrame(const int32_t *samples)
+{
+    uint32_t first = (uint32_t)samples[0] & SIM_SAMPLE_MASK;
+    uint32_t jump;
+    bool forward;
+    bool silent = (samples[0] == 0);
+
+#if AUDIO_NUM_CHANNELS > 1
+    silent = silent && (samples[1] == 0);
+#endif
+    check.frames++;
+    if (!check.locked) {
+        //Silence until the stream primes
+        if (silent) {
+            check.leading++;
+            return;
+        }
+        check.locked = true;
+        check.expected = first;
+    }
+    if (silent && (first != check.expected)) {
+        check.zero++;
+        if (opts.verbose || (check.events++ < SIM_MAX_EVENTS)) {
+            printf("frame %llu: zero\n", (unsigned long long)check.frames - 1);
+        }
+        return;
+    }
+#if AUDIO_NUM_CHANNELS > 1
+    if (((uint32_t)samples[1] & SIM_SAMPLE_MASK) != (~first & SIM_SAMPLE_MASK)) {
+        check.corrupt++;
+        if (opts.verbose || (check.events++ < SIM_MAX_EVENTS)) {
+            printf("frame %llu: corrupt 0x%x/0x%x\n", (unsigned long long)check.frames - 1,
+                   (unsigned)first, (unsigned)samples[1] & SIM_SAMPLE_MASK);
+        }
+        check.expected = (first + 1) & SIM_SAMPLE_MASK;
+        return;
+    }
+#endif
+    if (first != check.expected) {
+        //Half the counter range either way decides forward or back
+        jump = (first - check.expected) & SIM_SAMPLE_MASK;
+        forward = (jump < (SIM_SAMPLE_MASK / 2));
+        if (!forward) {
+            jump = SIM_SAMPLE_MASK + 1 - jump;
+        }
+        if (forward) {
+            check.dropped += jump;
+        } else {
+            check.duplicated += jump;
+        }
+        if (opts.verbose || (check.events++ < SIM_MAX_EVENTS)) {
+            printf("frame %llu: %s %u frames\n", (unsigned long long)check.frames - 1,
+                   forward ? "dropped" : "duplicated", (unsigned)jump);
+        }
+    }
+    check.expected = (first + 1) & SIM_SAMPLE_MASK;
+}
+
+void SimConsole(const uint8_t *data, uint32_t len, void *arg)
+{
+    (void)arg;
+    fwrite(data, 1, len, stdout);
+}
+
+/**
+ * The host selects the rate and opens the stream, and the faults start
+ */
+void SimStartStream(void *arg)
+{
+    (void)arg;
+    if (opts.rate != AUDIO_SAMPLE_RATE) {
+        MockUsbSetSampleRate(opts.rate);
+    }
+    MockUsbSetStream(true);
+    streaming = true;
+    streamStartFrame = (uint64_t)ceil(MockI2sFramePos());
+
+    MockUsbSetJitter(opts.jitterUs * 1000);
+    MockUsbSetMissRate(opts.missPermille);
+    MockDmaSetIsrDelay(opts.isrDelayUs * 1000, opts.isrDelayUs ? opts.isrDelayPermille : 0);
+    if (opts.stallEveryMs != 0) {
+        MockAt(MockNow() + (MockRandom() % (2 * opts.stallEveryMs)) * SIM_NS_PER_MS, SimStall,
+               NULL);
+    }
+}
+
+/**
+ * Holds the I2S or the USB task off the CPU for a while, as a long critical
+ * section or a busy higher priority task would
+ */
+void SimStall(void *arg)
+{
+    static const char *const names[] = { "I2S", "USBD" };
+    uint64_t now = MockNow();
+
+    (void)arg;
+    if (MockStallTask(names[MockRandom() % 2],
+                      now + (MockRandom() % (opts.stallMaxMs * 1000 + 1)) * 1000)) {
+        stalls++;
+    }
+    MockAt(now + (1 + MockRandom() % (2 * opts.stallEveryMs)) * SIM_NS_PER_MS, SimStall, NULL);
+}
+
+/**
+ * Reads a little endian sample, sign extended
+ */
+int32_t SimGetSample(const uint8_t *p, uint32_t width)
+{
+    uint32_t v = 0;
+    uint32_t i;
+
+    for (i = 0; i < width; i++) {
+        v |= (uint32_t)p[i] << (8 * i);
+    }
+    //4 byte subslots carry 24 bits MSB aligned
+    if ((width == 4) && (AUDIO_SAMPLE_BITS == 24)) {
+        return (int32_t)v >> 8;
+    }
+    return (int32_t)(v << (32 - 8 * width)) >> (32 - 8 * width);
+}
+
+/**
+ * Gets whether a frame carries the pattern rather than zero fill, so it can be
+ * timed. Frame 0 of a mono stream can't be told from silence
+ */
+bool SimIsPattern(const int32_t *samples)
+{
+    if (AUDIO_NUM_CHANNELS > 1) {
+        return ((uint32_t)samples[1] & SIM_SAMPLE_MASK) ==
+               (~(uint32_t)samples[0] & SIM_SAMPLE_MASK);
+    }
+    return samples[0] != 0;
+}
+
+/**
+ * Adds a received frame to those checked against the golden file
+ */
+void SimKeepFrame(const int32_t *samples)
+{
+    int32_t *grown;
+
+    if (rxCount == rxRoom) {
+        rxRoom = rxRoom ? (rxRoom * 2) : (uint64_t)opts.rate * 16;
+        grown = realloc(rxFrames, rxRoom * AUDIO_NUM_CHANNELS * sizeof(int32_t));
+        if (grown == NULL) {
+            fprintf(stderr, "Out of memory for %llu received frames\n",
+                    (unsigned long long)rxRoom);
+            exit(2);
+        }
+        rxFrames = grown;
+    }
+    memcpy(&rxFrames[rxCount * AUDIO_NUM_CHANNELS], samples, AUDIO_NUM_CHANNELS * sizeof(int32_t));
+    rxCount++;
+}
+
+/**
+ * Lines up what the host received with the golden file, up to a second either
+ * way
+ * @param result - Filled in
+ * @returns false if the golden file could not be read
+ */
+bool SimCompareGolden(wav_compare_t *result)
+{
+    wav_file_t golden;
+    const wav_file_t *ref = &inWav;
+    int32_t *refFrames;
+    uint32_t frame;
+    uint32_t ch;
+
+    if (opts.goldenPath != NULL) {
+        if (!WavRead(&golden, opts.goldenPath)) {
+            return false;
+        }
+        ref = &golden;
+    }
+    refFrames = malloc(((size_t)ref->frames * AUDIO_NUM_CHANNELS + 1) * sizeof(int32_t));
+    if (refFrames == NULL) {
+        fprintf(stderr, "Out of memory for the golden file\n");
+        exit(2);
+    }
+    for (frame = 0; frame < ref->frames; frame++) {
+        for (ch = 0; ch < AUDIO_NUM_CHANNELS; ch++) {
+            refFrames[frame * AUDIO_NUM_CHANNELS + ch] =
+                WavSample(ref, frame, ch, AUDIO_SAMPLE_BITS);
+        }
+    }
+    WavCompare(refFrames, ref->frames, rxFrames, rxCount, AUDIO_NUM_CHANNELS, opts.rate,
+               opts.verbose ? UINT32_MAX : SIM_MAX_EVENTS, result);
+    free(refFrames);
+    if (ref == &golden) {
+        WavFree(&golden);
+    }
+    return true;
+}
+
+/**
+ * Prints what happened and decides whether it passed
+ * @returns Exit code, 0 on a pass
+ */
+int SimReport(void)
+{
+    audio_stats_snapshot_t snap;
+    mock_usb_stats_t usb;
+    mock_dma_stats_t dma;
+    uint32_t capacity = I2S_TaskCapacityBytes() / AUDIO_FRAME_BYTES;
+    uint32_t buffers = (I2S_TaskCapacityBytes() / I2S_TaskBufferBytes()) + 2;
+    double bufferUs = ((double)I2S_TaskBufferBytes() / AUDIO_FRAME_BYTES) * 1e6 / opts.rate;
+    double limitUs = opts.maxLatencyUs;
+    int32_t drift = USB_TaskDriftPpm();
+    bool settled = (opts.seconds >= SIM_DRIFT_SETTLE_SEC);
+    wav_compare_t golden;
+    bool goldenRead = false;
+    bool pass = true;
+
+    AudioStatsSnapshot(&snap);
+    MockUsbGetStats(&usb);
+    MockDmaGetStats(&dma);
+    if (limitUs <= 0) {
+        //Anything older would have had to sit in a full ring, then wait a
+        //service interval in the endpoint
+        limitUs = (double)buffers * bufferUs + (opts.fullSpeed ? 1000 : 125);
+    }
+
+    printf("Stream: %u Hz, %u ch, %u bit in %u byte subslots, %s speed, %u x %.0fus buffers\n",
+           (unsigned)opts.rate, (unsigned)AUDIO_NUM_CHANNELS, (unsigned)AUDIO_SAMPLE_BITS,
+           (unsigned)AUDIO_BYTES_PER_SAMPLE, opts.fullSpeed ? "full" : "high", (unsigned)buffers,
+           bufferUs);
+    printf("USB: %u polls, %u packets, %llu bytes, %u empty, %u missed, largest %u\n",
+           (unsigned)usb.polls, (unsigned)usb.packets, (unsigned long long)usb.bytes,
+           (unsigned)usb.emptyPolls, (unsigned)usb.missedPolls, (unsigned)usb.maxPacket);
+    printf("Pipeline: %u DMA buffers, %u overruns, %u gaps, %u underflows, %u priming, "
+           "%u ISRs delayed\n",
+           (unsigned)snap.session.counts[AUDIO_STAT_DMA_DONE],
+           (unsigned)snap.session.counts[AUDIO_STAT_DMA_OVERRUN],
+           (unsigned)snap.session.counts[AUDIO_STAT_SEQ_GAP],
+           (unsigned)snap.session.counts[AUDIO_STAT_USB_UNDERFLOW],
+           (unsigned)snap.session.counts[AUDIO_STAT_USB_PRIME], (unsigned)dma.delayed);
+    if (inWav.data != NULL) {
+        goldenRead = SimCompareGolden(&golden);
+        if (goldenRead) {
+            printf("Golden: %llu frames, %llu leading, %llu skipped, %llu matched, "
+                   "%llu dropped, %llu duplicated, %llu zero, %llu corrupt, %llu trailing\n",
+                   (unsigned long long)golden.frames, (unsigned long long)golden.leading,
+                   (unsigned long long)golden.skipped, (unsigned long long)golden.matched,
+                   (unsigned long long)golden.dropped, (unsigned long long)golden.duplicated,
+                   (unsigned long long)golden.zero, (unsigned long long)golden.corrupt,
+                   (unsigned long long)golden.trailing);
+        }
+    } else {
+        printf("Frames: %llu, %llu leading, %llu dropped, %llu duplicated, %llu zero, "
+               "%llu corrupt\n",
+               (unsigned long long)check.frames, (unsigned long long)check.leading,
+               (unsigned long long)check.dropped, (unsigned long long)check.duplicated,
+               (unsigned long long)check.zero, (unsigned long long)check.corrupt);
+    }
+    if (latencyCount > 0) {
+        printf("Latency: min %.0fus, avg %.0fus, max %.0fus (limit %.0fus)\n", latencyMinUs,
+               latencySumUs / latencyCount, latencyMaxUs, limitUs);
+    }
+    printf("Occupancy: max %u of %u frames (%u%%), fill %u-%u frames\n", (unsigned)occupancyMax,
+           (unsigned)capacity, (unsigned)((occupancyMax * 100ULL) / capacity),
+           (unsigned)((snap.session.fillMin == UINT32_MAX) ? 0 : snap.session.fillMin),
+           (unsigned)snap.session.fillMax);
+    //Before the loop settles the estimate is still moving, so say so rather
+    //than have it read as a result
+    printf("Drift: estimate %d ppm%s, codec at %+.1f ppm\n", (int)drift,
+           settled ? "" : " (transient, not settled)", opts.ppm);
+    if (opts.bench) {
+        //The stream carries audio at the rate the codec sets; the host runs it
+        //as fast as it can
+        printf("Throughput: %.3f MB/s sustained for %.0fs, %u packets of up to %u bytes\n",
+               ((double)usb.bytes / 1e6) / opts.seconds, opts.seconds, (unsigned)usb.packets,
+               (unsigned)usb.maxPacket);
+        printf("Host: %.2fs for %.0fs of audio, %.0fx real time, %.2f MB/s\n", wallSec,
+               opts.seconds, opts.seconds / wallSec, ((double)usb.bytes / 1e6) / wallSec);
+    }
+    if ((opts.jitterUs | opts.missPermille | opts.stallEveryMs | opts.isrDelayUs) != 0) {
+        printf("Faults: seed %u, %u polls missed, %u task stalls, %u ISRs delayed\n",
+               (unsigned)opts.seed, (unsigned)usb.missedPolls, (unsigned)stalls,
+               (unsigned)dma.delayed);
+    }
+
+#define SIM_FAIL_IF(cond, what)          \
+    do {                                 \
+        if (cond) {                      \
+            printf("FAIL: %s\n", (what)); \
+            pass = false;                \
+        }                                \
+    } while (0)
+    SIM_FAIL_IF(usb.packets == 0, "no audio reached the host");
+    SIM_FAIL_IF(snap.session.counts[AUDIO_STAT_DMA_OVERRUN] != 0, "DMA overruns");
+    SIM_FAIL_IF(snap.session.counts[AUDIO_STAT_USB_UNDERFLOW] != 0, "USB underflows");
+    SIM_FAIL_IF(dma.starved != 0, "DMA ran out of reloads");
+    SIM_FAIL_IF(usb.fifoOverflows + usb.fifoLeftovers != 0, "packets did not fit the endpoint");
+    SIM_FAIL_IF(usb.controlFailures != 0, "control requests failed");
+    SIM_FAIL_IF(occupancyMax >= capacity, "capture ring filled up");
+    SIM_FAIL_IF((occupancyMax * 100ULL) > ((uint64_t)capacity * opts.maxOccupancy),
+                "capture ring over the occupancy limit");
+    if (inWav.data != NULL) {
+        SIM_FAIL_IF(!goldenRead, "golden file unreadable");
+        SIM_FAIL_IF(goldenRead && !WavCompareClean(&golden), "stream differs from the golden file");
+        SIM_FAIL_IF(goldenRead && (golden.trailing != 0), "input ran out before the run ended");
+    } else {
+        SIM_FAIL_IF(check.dropped + check.duplicated + check.zero + check.corrupt != 0,
+                    "stream was not continuous");
+        SIM_FAIL_IF(latencyMaxUs > limitUs, "latency over the limit");
+    }
+    SIM_FAIL_IF((opts.driftTolerance >= 0) && !settled, "too short for the drift estimate to settle");
+    SIM_FAIL_IF((opts.driftTolerance >= 0) && settled && (fabs(drift - opts.ppm) > opts.driftTolerance),
+                "drift estimate off");
+    printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,148 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#include "WavCompare.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static bool WavFrameSilent(const int32_t *frame, uint32_t channels);
+static bool WavRunMatches(const int32_t *ref, uint64_t refFrames, uint64_t refPos,
+                          const int32_t *rx, uint64_t rxFrames, uint64_t rxPos,
+                          uint32_t channels);
+
+void WavCompare(const int32_t *ref, uint64_t refFrames, const int32_t *rx, uint64_t rxFrames,
+                uint32_t channels, uint32_t window, uint32_t maxEvents, wav_compare_t *result)
+{
+    uint64_t i = 0;
+    uint64_t e = 0;
+    uint64_t d;
+    uint32_t events = 0;
+    bool found;
+
+    memset(result, 0, sizeof(*result));
+    result->frames = rxFrames;
+
+    //Silence until the stream primes, then find where in the reference it is
+    while ((i < rxFrames) && WavFrameSilent(&rx[i * channels], channels)) {
+        i++;
+    }
+    result->leading = i;
+    if (i == rxFrames) {
+        return;
+    }
+    while ((e < refFrames) && !WavRunMatches(ref, refFrames, e, rx, rxFrames, i, channels)) {
+        e++;
+    }
+    if (e == refFrames) {
+        result->corrupt = rxFrames - i;
+        return;
+    }
+    result->aligned = true;
+    result->skipped = e;
+
+    for (; i < rxFrames; i++) {
+        if (e >= refFrames) {
+            result->trailing = rxFrames - i;
+            break;
+        }
+        if (memcmp(&rx[i * channels], &ref[e * channels], channels * sizeof(int32_t)) == 0) {
+            result->matched++;
+            e++;
+            continue;
+        }
+        if (WavFrameSilent(&rx[i * channels], channels)) {
+            result->zero++;
+            if (events++ < maxEvents) {
+                printf("frame %llu: zero\n", (unsigned long long)i);
+            }
+            continue;
+        }
+
+        //Nearest jump that lines the next few frames up again
+        found = false;
+        for (d = 1; (d <= window) && !found; d++) {
+            if (WavRunMatches(ref, refFrames, e + d, rx, rxFrames, i, channels)) {
+                result->dropped += d;
+                e += d;
+                found = true;
+                if (events++ < maxEvents) {
+                    printf("frame %llu: dropped %llu frames\n", (unsigned long long)i,
+                           (unsigned long long)d);
+                }
+            } else if ((d <= e) &&
+                       WavRunMatches(ref, refFrames, e - d, rx, rxFrames, i, channels)) {
+                result->duplicated += d;
+                e -= d;
+                found = true;
+                if (events++ < maxEvents) {
+                    printf("frame %llu: duplicated %llu frames\n", (unsigned long long)i,
+                           (unsigned long long)d);
+                }
+            }
+        }
+        if (found) {
+            result->matched++;
+        } else {
+            result->corrupt++;
+            if (events++ < maxEvents) {
+                printf("frame %llu: corrupt\n", (unsigned long long)i);
+            }
+        }
+        e++;
+    }
+}
+
+bool WavCompareClean(const wav_compare_t *result)
+{
+    return result->aligned &&
+           ((result->dropped + result->duplicated + result->zero + result->corrupt) == 0);
+}
+
+bool WavFrameSilent(const int32_t *frame, uint32_t channels)
+{
+    uint32_t ch;
+
+    for (ch = 0; ch < channels; ch++) {
+        if (frame[ch] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Checks received frames against the reference from a given place, for
+ * WAV_COMPARE_RUN frames or to the end of either
+ */
+bool WavRunMatches(const int32_t *ref, uint64_t refFrames, uint64_t refPos, const int32_t *rx,
+                   uint64_t rxFrames, uint64_t rxPos, uint32_t channels)
+{
+    uint64_t n = WAV_COMPARE_RUN;
+
+    if (refPos >= refFrames) {
+        return false;
+    }
+    if (n > refFrames - refPos) {
+        n = refFrames - refPos;
+    }
+    if (n > rxFrames - rxPos) {
+        n = rxFrames - rxPos;
+    }
+    return memcmp(&rx[rxPos * channels], &ref[refPos * channels],
+                  n * channels * sizeof(int32_t)) == 0;
+}
@@ -0,0 +1,76 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_WAVCOMPARE_H_
+#define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_WAVCOMPARE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Lines a received stream up against a golden reference, frame by frame, and
+ * classifies every difference the way the pattern check does. Frames are
+ * interleaved signed samples at the same width on both sides.
+ *
+ * Silence before the first frame of audio is leading, and so is any of the
+ * reference the receiver started after. From there each received frame should
+ * be the next reference frame. A silent frame where the reference has audio
+ * is zero fill, and the reference does not move on. Otherwise the next few
+ * received frames are looked for a little further on in the reference
+ * (dropped) or back (duplicated), and if they are in neither the frame is
+ * corrupt. Frames received once the reference has run out are trailing.
+ */
+
+/* Frames to match when lining up, so a repeat in the audio isn't taken for a
+ * jump */
+#define WAV_COMPARE_RUN 4
+
+typedef struct {
+    uint64_t frames; /**< Received */
+    uint64_t leading; /**< Silent before the audio started */
+    uint64_t skipped; /**< Reference frames before the first one received */
+    uint64_t matched;
+    uint64_t dropped; /**< Reference frames never received */
+    uint64_t duplicated; /**< Reference frames received again */
+    uint64_t zero; /**< Silence received in place of audio */
+    uint64_t corrupt; /**< Received frames found nowhere near their place */
+    uint64_t trailing; /**< Received after the reference ran out */
+    bool aligned; /**< false if no audio from the reference was found at all */
+} wav_compare_t;
+
+/**
+ * Compares a received stream with a reference
+ * @param ref - Reference frames
+ * @param refFrames - Number of them
+ * @param rx - Received frames
+ * @param rxFrames - Number of them
+ * @param channels - Samples per frame, both sides
+ * @param window - Furthest a drop or duplicate is looked for, in frames
+ * @param maxEvents - Differences to print, as they are found
+ * @param result - Filled in
+ */
+void WavCompare(const int32_t *ref, uint64_t refFrames, const int32_t *rx, uint64_t rxFrames,
+                uint32_t channels, uint32_t window, uint32_t maxEvents, wav_compare_t *result);
+
+/**
+ * Gets whether a comparison found anything but leading and trailing frames
+ * @param result - From WavCompare
+ * @returns true if every frame of audio received matched its place
+ */
+bool WavCompareClean(const wav_compare_t *result);
+
+#endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_WAVCOMPARE_H_
@@ -0,0 +1,171 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#include "WavFile.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WAV_HEADER_BYTES 44
+
+static uint32_t WavLe32(const uint8_t *p);
+static void WavPutLe32(uint8_t *p, uint32_t v);
+
+bool WavRead(wav_file_t *wav, const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    uint8_t hdr[12];
+    uint8_t fmt[16];
+    uint32_t size;
+    bool haveFmt = false;
+
+    memset(wav, 0, sizeof(*wav));
+    if (f == NULL) {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return false;
+    }
+    if ((fread(hdr, 1, 12, f) != 12) || (memcmp(hdr, "RIFF", 4) != 0) ||
+        (memcmp(&hdr[8], "WAVE", 4) != 0)) {
+        fprintf(stderr, "%s: not a WAV file\n", path);
+        fclose(f);
+        return false;
+    }
+    //Chunks in any order, fmt before data
+    while (fread(hdr, 1, 8, f) == 8) {
+        size = WavLe32(&hdr[4]);
+        if ((memcmp(hdr, "fmt ", 4) == 0) && (size >= 16)) {
+            if (fread(fmt, 1, 16, f) != 16) {
+                break;
+            }
+            fseek(f, (long)(size - 16 + (size & 1)), SEEK_CUR);
+            wav->channels = fmt[2] | (fmt[3] << 8);
+            wav->rate = WavLe32(&fmt[4]);
+            wav->width = (fmt[14] | (fmt[15] << 8)) / 8;
+            haveFmt = ((fmt[0] | (fmt[1] << 8)) == 1) || ((fmt[0] | (fmt[1] << 8)) == 0xFFFE);
+        } else if ((memcmp(hdr, "data", 4) == 0) && haveFmt) {
+            if ((wav->width < 2) || (wav->width > 4) || (wav->channels == 0)) {
+                break;
+            }
+            wav->data = malloc(size ? size : 1);
+            if ((wav->data == NULL) || (fread(wav->data, 1, size, f) != size)) {
+                break;
+            }
+            wav->frames = size / (wav->channels * wav->width);
+            fclose(f);
+            return true;
+        } else {
+            fseek(f, (long)(size + (size & 1)), SEEK_CUR);
+        }
+    }
+    fprintf(stderr, "%s: no 16 to 32 bit PCM data\n", path);
+    fclose(f);
+    WavFree(wav);
+    return false;
+}
+
+void WavFree(wav_file_t *wav)
+{
+    free(wav->data);
+    wav->data = NULL;
+    wav->frames = 0;
+}
+
+int32_t WavSample(const wav_file_t *wav, uint32_t frame, uint32_t channel, uint32_t bits)
+{
+    const uint8_t *p;
+    uint32_t fileBits = wav->width * 8;
+    uint32_t v = 0;
+    uint32_t i;
+    int32_t s;
+
+    if (channel >= wav->channels) {
+        channel = wav->channels - 1;
+    }
+    p = &wav->data[((frame * wav->channels) + channel) * wav->width];
+    for (i = 0; i < wav->width; i++) {
+        v |= (uint32_t)p[i] << (8 * i);
+    }
+    s = (int32_t)(v << (32 - fileBits)) >> (32 - fileBits);
+    if (fileBits > bits) {
+        return s >> (fileBits - bits);
+    }
+    return (int32_t)((uint32_t)s << (bits - fileBits));
+}
+
+bool WavWriterOpen(wav_writer_t *wav, const char *path, uint32_t channels, uint32_t width,
+                   uint32_t rate)
+{
+    uint8_t hdr[WAV_HEADER_BYTES] = { 0 };
+
+    wav->file = fopen(path, "wb");
+    if (wav->file == NULL) {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return false;
+    }
+    wav->channels = channels;
+    wav->width = width;
+    wav->rate = rate;
+    wav->frames = 0;
+    //Sizes are filled in on close
+    fwrite(hdr, 1, sizeof(hdr), wav->file);
+    return true;
+}
+
+void WavWriterWrite(wav_writer_t *wav, const uint8_t *data, uint32_t len)
+{
+    fwrite(data, 1, len, wav->file);
+    wav->frames += len / (wav->channels * wav->width);
+}
+
+void WavWriterClose(wav_writer_t *wav)
+{
+    uint8_t hdr[WAV_HEADER_BYTES];
+    uint32_t dataBytes;
+
+    if (wav->file == NULL) {
+        return;
+    }
+    dataBytes = wav->frames * wav->channels * wav->width;
+    memcpy(&hdr[0], "RIFF", 4);
+    WavPutLe32(&hdr[4], 36 + dataBytes);
+    memcpy(&hdr[8], "WAVEfmt ", 8);
+    WavPutLe32(&hdr[16], 16);
+    WavPutLe32(&hdr[20], 1 | (wav->channels << 16)); //PCM
+    WavPutLe32(&hdr[24], wav->rate);
+    WavPutLe32(&hdr[28], wav->rate * wav->channels * wav->width);
+    WavPutLe32(&hdr[32], (wav->channels * wav->width) | ((wav->width * 8) << 16));
+    memcpy(&hdr[36], "data", 4);
+    WavPutLe32(&hdr[40], dataBytes);
+    fseek(wav->file, 0, SEEK_SET);
+    fwrite(hdr, 1, sizeof(hdr), wav->file);
+    fclose(wav->file);
+    wav->file = NULL;
+}
+
+uint32_t WavLe32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+void WavPutLe32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
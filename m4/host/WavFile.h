@@ -0,0 +1,99 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_WAVFILE_H_
+#define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_WAVFILE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * Just enough of the WAV format for the host harnesses: 16 to 32 bit
+ * little endian PCM, read whole, written a block at a time.
+ */
+
+/* A PCM WAV file read into memory */
+typedef struct {
+    uint32_t channels;
+    uint32_t width; /**< Bytes per sample */
+    uint32_t rate;
+    uint32_t frames;
+    uint8_t *data; /**< Interleaved samples as they were in the file */
+} wav_file_t;
+
+/* A PCM WAV file being written */
+typedef struct {
+    FILE *file;
+    uint32_t channels;
+    uint32_t width; /**< Bytes per sample */
+    uint32_t rate;
+    uint32_t frames;
+} wav_writer_t;
+
+/**
+ * Reads a whole WAV file. Prints why on failure
+ * @param wav - Filled in. Free data with WavFree
+ * @param path - File to read
+ * @returns true on success
+ */
+bool WavRead(wav_file_t *wav, const char *path);
+
+/**
+ * Frees what WavRead allocated
+ * @param wav - File read with WavRead
+ */
+void WavFree(wav_file_t *wav);
+
+/**
+ * Gets one sample of a file read with WavRead, scaled to a bit width the way
+ * the I2S would deliver it: cut to the top bits, or padded below with zeros
+ * @param wav - The file
+ * @param frame - Frame index, less than wav->frames
+ * @param channel - Channel index. Past the file's last, the last repeats
+ * @param bits - Width wanted, 16 to 32
+ * @returns Signed sample
+ */
+int32_t WavSample(const wav_file_t *wav, uint32_t frame, uint32_t channel, uint32_t bits);
+
+/**
+ * Starts a WAV file. Prints why on failure
+ * @param wav - Writer state
+ * @param path - File to create
+ * @param channels - Channels per frame
+ * @param width - Bytes per sample, 2 to 4
+ * @param rate - Frames per second
+ * @returns true on success
+ */
+bool WavWriterOpen(wav_writer_t *wav, const char *path, uint32_t channels, uint32_t width,
+                   uint32_t rate);
+
+/**
+ * Appends whole frames already in the file's sample format
+ * @param wav - Writer state
+ * @param data - Interleaved little endian samples
+ * @param len - Bytes, a multiple of the frame size
+ */
+void WavWriterWrite(wav_writer_t *wav, const uint8_t *data, uint32_t len);
+
+/**
+ * Fills in the sizes and closes the file. Does nothing if it isn't open
+ * @param wav - Writer state
+ */
+void WavWriterClose(wav_writer_t *wav);
+
+#endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_WAVFILE_H_
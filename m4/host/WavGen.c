@@ -0,0 +1,107 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+/**
+ * Writes a test signal for the golden file runs: a different tone on each
+ * channel with a little noise under it, so no run of frames ever repeats and
+ * a comparison can always tell where in the file it is.
+ *
+ * Usage: WavGen FILE SECONDS [RATE [BITS [CHANNELS]]]
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "WavFile.h"
+
+#define WAVGEN_BLOCK_FRAMES 1024
+#define WAVGEN_MAX_CHANNELS 8
+
+int main(int argc, char **argv)
+{
+    static const double tones[WAVGEN_MAX_CHANNELS] = { 440, 1001, 97, 5003, 223, 2999, 61, 7919 };
+    uint8_t block[WAVGEN_BLOCK_FRAMES * WAVGEN_MAX_CHANNELS * 4];
+    wav_writer_t wav;
+    uint32_t rate = 48000;
+    uint32_t bits = 16;
+    uint32_t channels = 2;
+    uint32_t frames;
+    uint32_t frame;
+    uint32_t n;
+    uint32_t ch;
+    uint32_t i;
+    uint32_t noise = 0x2545F491;
+    uint8_t *p;
+    int32_t s;
+    int32_t step;
+    double full;
+
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s FILE SECONDS [RATE [BITS [CHANNELS]]]\n", argv[0]);
+        return 2;
+    }
+    if (argc > 3) {
+        rate = (uint32_t)strtoul(argv[3], NULL, 0);
+    }
+    if (argc > 4) {
+        bits = (uint32_t)strtoul(argv[4], NULL, 0);
+    }
+    if (argc > 5) {
+        channels = (uint32_t)strtoul(argv[5], NULL, 0);
+    }
+    if ((rate == 0) || ((bits != 16) && (bits != 24) && (bits != 32)) || (channels == 0) ||
+        (channels > WAVGEN_MAX_CHANNELS)) {
+        fprintf(stderr, "%s: 16, 24 or 32 bits and 1 to %u channels\n", argv[0],
+                WAVGEN_MAX_CHANNELS);
+        return 2;
+    }
+    if (!WavWriterOpen(&wav, argv[1], channels, bits / 8, rate)) {
+        return 1;
+    }
+
+    //Half scale tones, with 8 bits of noise scaled to 16 bit steps so it is
+    //still there once the stream truncates a wider file
+    full = (double)(1UL << (bits - 2));
+    step = 1 << (bits - 16);
+    frames = (uint32_t)(atof(argv[2]) * rate);
+    for (frame = 0; frame < frames; frame += n) {
+        n = ((frames - frame) < WAVGEN_BLOCK_FRAMES) ? (frames - frame) : WAVGEN_BLOCK_FRAMES;
+        p = block;
+        for (i = 0; i < n; i++) {
+            for (ch = 0; ch < channels; ch++) {
+                noise ^= noise << 13;
+                noise ^= noise >> 17;
+                noise ^= noise << 5;
+                s = (int32_t)lrint(full * sin(2 * M_PI * tones[ch] * (frame + i) / rate)) +
+                    ((int32_t)(noise >> 24) - 128) * step;
+                *p++ = (uint8_t)s;
+                *p++ = (uint8_t)(s >> 8);
+                if (bits > 16) {
+                    *p++ = (uint8_t)(s >> 16);
+                }
+                if (bits > 24) {
+                    *p++ = (uint8_t)(s >> 24);
+                }
+            }
+        }
+        WavWriterWrite(&wav, block, (uint32_t)(p - block));
+    }
+    WavWriterClose(&wav);
+    return 0;
+}
@@ -0,0 +1,55 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_FREERTOS_H_
+#define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_FREERTOS_H_
+
+/* Host build of the FreeRTOS API the firmware uses, see MockKernel.h. Takes
+ * the firmware's own FreeRTOSConfig.h, so tick rate and stack sizes match */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "FreeRTOSConfig.h"
+#include "MockKernel.h"
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t StackType_t;
+#define portTickType TickType_t
+
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE ((BaseType_t)1)
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFUL)
+#define portTICK_PERIOD_MS ((TickType_t)1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(xTimeInMs) \
+    ((TickType_t)(((TickType_t)(xTimeInMs) * (TickType_t)configTICK_RATE_HZ) / (TickType_t)1000U))
+
+/* Cooperative, so there is never anything to switch to from an ISR, and a
+ * critical section only has its masked time counted */
+#define portYIELD_FROM_ISR(x) (void)(x)
+#define taskDISABLE_INTERRUPTS()
+#define taskENTER_CRITICAL() MockMaskBegin()
+#define taskEXIT_CRITICAL() MockMaskEnd()
+
+BaseType_t xPortIsInsideInterrupt(void);
+
+#endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_FREERTOS_H_
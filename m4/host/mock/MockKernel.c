@@ -0,0 +1,776 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#define _GNU_SOURCE
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <ucontext.h>
+
+#include "MockKernel.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "stream_buffer.h"
+
+/* Host stacks, far more than the target's. printf alone wants a few KB */
+#define MOCK_STACK_BYTES (256 * 1024)
+#define MOCK_MAX_TASKS 16
+
+struct tskTaskControlBlock {
+    ucontext_t ctx;
+    void *stack;
+    TaskFunction_t fn;
+    void *param;
+    const char *name;
+    UBaseType_t prio;
+    uint32_t notify; /**< Notification count, atomic, host threads give too */
+    bool waiting; /**< Blocked in MockWait */
+    bool met; /**< Why MockWait returned: condition (true) or timeout */
+    mock_ready_fn_t ready;
+    void *readyArg;
+    uint64_t deadline;
+    uint64_t stallUntil; /**< Not run before this, see MockStallTask */
+    uint64_t lastRun; /**< Dispatch order, for round robin */
+};
+
+struct QueueDefinition {
+    uint8_t *items;
+    UBaseType_t length;
+    UBaseType_t itemSize;
+    UBaseType_t count;
+    UBaseType_t head;
+};
+
+/* Laid out as FreeRTOS does it: one byte more than asked for, so head equal
+ * to tail always means empty */
+struct StreamBufferDef_t {
+    uint8_t *storage;
+    size_t length;
+    size_t head; /**< Next byte written */
+    size_t tail; /**< Next byte read */
+};
+
+typedef struct {
+    uint64_t when;
+    uint32_t id; /**< Increasing, so also the order for equal times */
+    mock_event_fn_t fn; /**< NULL once cancelled */
+    void *arg;
+} mock_event_t;
+
+static struct tskTaskControlBlock *tasks[MOCK_MAX_TASKS];
+static int numTasks;
+static struct tskTaskControlBlock *current;
+static ucontext_t schedulerCtx;
+static uint64_t runCount;
+
+static uint64_t now;
+static uint64_t stopAt = MOCK_FOREVER;
+static bool stopNow;
+static bool externalWakers;
+static __thread bool inInterrupt;
+static uint32_t rngState = 0x2545F491;
+
+/* Pending events, a binary heap on (when, id) */
+static mock_event_t *events;
+static uint32_t numEvents;
+static uint32_t maxEvents;
+static uint32_t nextEventId = 1;
+
+/* Host time spent where the target would have interrupts masked */
+static uint32_t maskDepth;
+static uint64_t maskStart;
+static uint64_t maskedNs;
+
+static void MockTaskEntry(void);
+static bool MockTaskCanRun(struct tskTaskControlBlock *t);
+static struct tskTaskControlBlock *MockPickTask(void);
+static uint64_t MockNextTime(void);
+static void MockRunDueEvents(void);
+static bool MockEventBefore(const mock_event_t *a, const mock_event_t *b);
+static void MockEventPop(void);
+static uint64_t MockTicksToDeadline(TickType_t ticks);
+static bool MockNotifyPending(void *arg);
+static bool MockQueueHasSpace(void *arg);
+static bool MockQueueHasItems(void *arg);
+static bool MockStreamHasSpace(void *arg);
+static uint64_t MockHostNs(void);
+
+uint64_t MockNow()
+{
+    return now;
+}
+
+bool MockInInterrupt()
+{
+    return inInterrupt;
+}
+
+void MockSeed(uint32_t seed)
+{
+    rngState = (seed != 0) ? seed : 0x2545F491;
+}
+
+uint32_t MockRandom()
+{
+    //xorshift32, as FaultInject.c
+    uint32_t x = rngState;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    rngState = x;
+    return x;
+}
+
+void MockMaskBegin()
+{
+    if (maskDepth++ == 0) {
+        maskStart = MockHostNs();
+    }
+}
+
+void MockMaskEnd()
+{
+    if (--maskDepth == 0) {
+        maskedNs += MockHostNs() - maskStart;
+    }
+}
+
+uint64_t MockMaskedNs()
+{
+    return maskedNs;
+}
+
+void MockStopAt(uint64_t when)
+{
+    stopAt = when;
+}
+
+void MockStop()
+{
+    stopNow = true;
+}
+
+void MockExternalWakers(bool enable)
+{
+    __atomic_store_n(&externalWakers, enable, __ATOMIC_RELEASE);
+}
+
+bool MockStallTask(const char *name, uint64_t until)
+{
+    int i;
+
+    for (i = 0; i < numTasks; i++) {
+        if (strcmp(tasks[i]->name, name) == 0) {
+            if (until > tasks[i]->stallUntil) {
+                tasks[i]->stallUntil = until;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t MockAt(uint64_t when, mock_event_fn_t fn, void *arg)
+{
+    uint32_t i;
+    mock_event_t tmp;
+
+    if (numEvents == maxEvents) {
+        maxEvents = (maxEvents == 0) ? 64 : (maxEvents * 2);
+        events = realloc(events, maxEvents * sizeof(events[0]));
+        if (events == NULL) {
+            fprintf(stderr, "Mock kernel: out of memory for events\n");
+            abort();
+        }
+    }
+    i = numEvents++;
+    events[i].when = when;
+    events[i].id = nextEventId++;
+    events[i].fn = fn;
+    events[i].arg = arg;
+    //Sift up
+    while ((i > 0) && MockEventBefore(&events[i], &events[(i - 1) / 2])) {
+        tmp = events[i];
+        events[i] = events[(i - 1) / 2];
+        events[(i - 1) / 2] = tmp;
+        i = (i - 1) / 2;
+    }
+    return events[i].id;
+}
+
+void MockCancel(uint32_t id)
+{
+    uint32_t i;
+
+    //Few events are ever pending, so a scan is fine. The slot stays in the
+    //heap and is skipped when it comes up
+    for (i = 0; i < numEvents; i++) {
+        if (events[i].id == id) {
+            events[i].fn = NULL;
+            return;
+        }
+    }
+}
+
+bool MockWait(mock_ready_fn_t ready, void *arg, uint64_t deadline)
+{
+    struct tskTaskControlBlock *t = current;
+
+    //Cooperative: a task that doesn't have to wait keeps the CPU
+    if ((ready != NULL) && ready(arg)) {
+        return true;
+    }
+    if (deadline <= now) {
+        return false;
+    }
+    if ((t == NULL) || inInterrupt) {
+        fprintf(stderr, "Mock kernel: blocking call outside a task\n");
+        abort();
+    }
+    t->ready = ready;
+    t->readyArg = arg;
+    t->deadline = deadline;
+    t->waiting = true;
+    swapcontext(&t->ctx, &schedulerCtx);
+    t->waiting = false;
+    return t->met;
+}
+
+void vTaskStartScheduler()
+{
+    struct tskTaskControlBlock *t;
+    uint64_t next;
+
+    stopNow = false;
+    for (;;) {
+        MockRunDueEvents();
+        if (stopNow) {
+            break;
+        }
+        t = MockPickTask();
+        if (t != NULL) {
+            current = t;
+            t->lastRun = ++runCount;
+            swapcontext(&schedulerCtx, &t->ctx);
+            current = NULL;
+            continue;
+        }
+
+        //Nothing can run, so move the clock on to whatever happens next
+        next = MockNextTime();
+        if (next == MOCK_FOREVER) {
+            if (__atomic_load_n(&externalWakers, __ATOMIC_ACQUIRE)) {
+                sched_yield();
+                continue;
+            }
+            if (stopAt == MOCK_FOREVER) {
+                fprintf(stderr, "Mock kernel: every task is blocked forever\n");
+                break;
+            }
+            next = stopAt;
+        }
+        if (next >= stopAt) {
+            now = stopAt;
+            break;
+        }
+        now = next;
+    }
+}
+
+BaseType_t xTaskCreate(TaskFunction_t pxTaskCode, const char *const pcName,
+                       const uint32_t usStackDepth, void *const pvParameters,
+                       UBaseType_t uxPriority, TaskHandle_t *const pxCreatedTask)
+{
+    struct tskTaskControlBlock *t;
+
+    (void)usStackDepth;
+    if (numTasks == MOCK_MAX_TASKS) {
+        return pdFAIL;
+    }
+    t = calloc(1, sizeof(*t));
+    if (t == NULL) {
+        return pdFAIL;
+    }
+    t->stack = malloc(MOCK_STACK_BYTES);
+    if (t->stack == NULL) {
+        free(t);
+        return pdFAIL;
+    }
+    t->fn = pxTaskCode;
+    t->param = pvParameters;
+    t->name = pcName;
+    t->prio = uxPriority;
+    getcontext(&t->ctx);
+    t->ctx.uc_stack.ss_sp = t->stack;
+    t->ctx.uc_stack.ss_size = MOCK_STACK_BYTES;
+    t->ctx.uc_link = NULL;
+    makecontext(&t->ctx, MockTaskEntry, 0);
+    tasks[numTasks++] = t;
+    if (pxCreatedTask != NULL) {
+        *pxCreatedTask = t;
+    }
+    return pdPASS;
+}
+
+void vTaskDelay(const TickType_t xTicksToDelay)
+{
+    if (xTicksToDelay == 0) {
+        taskYIELD();
+        return;
+    }
+    MockWait(NULL, NULL, MockTicksToDeadline(xTicksToDelay));
+}
+
+void taskYIELD()
+{
+    struct tskTaskControlBlock *t = current;
+
+    if ((t == NULL) || inInterrupt) {
+        return;
+    }
+    //Runs again after any other ready task at its priority
+    t->met = true;
+    swapcontext(&t->ctx, &schedulerCtx);
+}
+
+TickType_t xTaskGetTickCount()
+{
+    return (TickType_t)(now / MOCK_NS_PER_TICK);
+}
+
+TickType_t xTaskGetTickCountFromISR()
+{
+    return xTaskGetTickCount();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+    return current;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait)
+{
+    struct tskTaskControlBlock *t = current;
+
+    if (!MockWait(MockNotifyPending, t, MockTicksToDeadline(xTicksToWait))) {
+        return 0;
+    }
+    if (xClearCountOnExit) {
+        return __atomic_exchange_n(&t->notify, 0, __ATOMIC_ACQ_REL);
+    }
+    return __atomic_fetch_sub(&t->notify, 1, __ATOMIC_ACQ_REL);
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t xTaskToNotify)
+{
+    __atomic_fetch_add(&xTaskToNotify->notify, 1, __ATOMIC_ACQ_REL);
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    __atomic_fetch_add(&xTaskToNotify->notify, 1, __ATOMIC_ACQ_REL);
+    if (pxHigherPriorityTaskWoken != NULL) {
+        *pxHigherPriorityTaskWoken = pdTRUE;
+    }
+}
+
+BaseType_t xPortIsInsideInterrupt()
+{
+    return inInterrupt ? pdTRUE : pdFALSE;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t uxQueueLength, UBaseType_t uxItemSize)
+{
+    struct QueueDefinition *q = calloc(1, sizeof(*q));
+
+    if (q == NULL) {
+        return NULL;
+    }
+    q->length = uxQueueLength;
+    q->itemSize = uxItemSize;
+    if (uxItemSize != 0) {
+        q->items = malloc(uxQueueLength * uxItemSize);
+        if (q->items == NULL) {
+            free(q);
+            return NULL;
+        }
+    }
+    return q;
+}
+
+BaseType_t xQueueSend(QueueHandle_t xQueue, const void *pvItemToQueue, TickType_t xTicksToWait)
+{
+    BaseType_t woken;
+
+    if (!MockWait(MockQueueHasSpace, xQueue, MockTicksToDeadline(xTicksToWait))) {
+        return pdFAIL;
+    }
+    return xQueueSendFromISR(xQueue, pvItemToQueue, &woken);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait)
+{
+    BaseType_t woken;
+
+    if (!MockWait(MockQueueHasItems, xQueue, MockTicksToDeadline(xTicksToWait))) {
+        return pdFAIL;
+    }
+    return xQueueReceiveFromISR(xQueue, pvBuffer, &woken);
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t xQueue, const void *pvItemToQueue,
+                             BaseType_t *pxHigherPriorityTaskWoken)
+{
+    UBaseType_t tail;
+
+    //FreeRTOS copies the item in with interrupts masked, from a task or an ISR
+    MockMaskBegin();
+    if (xQueue->count == xQueue->length) {
+        MockMaskEnd();
+        return pdFAIL;
+    }
+    tail = (xQueue->head + xQueue->count) % xQueue->length;
+    if (xQueue->itemSize != 0) {
+        memcpy(&xQueue->items[tail * xQueue->itemSize], pvItemToQueue, xQueue->itemSize);
+    }
+    xQueue->count++;
+    MockMaskEnd();
+    if (pxHigherPriorityTaskWoken != NULL) {
+        *pxHigherPriorityTaskWoken = pdTRUE;
+    }
+    return pdPASS;
+}
+
+BaseType_t xQueueReceiveFromISR(QueueHandle_t xQueue, void *pvBuffer,
+                                BaseType_t *pxHigherPriorityTaskWoken)
+{
+    MockMaskBegin();
+    if (xQueue->count == 0) {
+        MockMaskEnd();
+        return pdFAIL;
+    }
+    if (xQueue->itemSize != 0) {
+        memcpy(pvBuffer, &xQueue->items[xQueue->head * xQueue->itemSize], xQueue->itemSize);
+    }
+    xQueue->head = (xQueue->head + 1) % xQueue->length;
+    xQueue->count--;
+    MockMaskEnd();
+    if (pxHigherPriorityTaskWoken != NULL) {
+        *pxHigherPriorityTaskWoken = pdTRUE;
+    }
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t xQueue)
+{
+    return xQueue->count;
+}
+
+BaseType_t xQueueReset(QueueHandle_t xQueue)
+{
+    xQueue->count = 0;
+    xQueue->head = 0;
+    return pdPASS;
+}
+
+StreamBufferHandle_t xStreamBufferCreate(size_t xBufferSizeBytes, size_t xTriggerLevelBytes)
+{
+    struct StreamBufferDef_t *sb = calloc(1, sizeof(*sb));
+
+    (void)xTriggerLevelBytes;
+    if (sb == NULL) {
+        return NULL;
+    }
+    sb->length = xBufferSizeBytes + 1;
+    sb->storage = malloc(sb->length);
+    if (sb->storage == NULL) {
+        free(sb);
+        return NULL;
+    }
+    return sb;
+}
+
+size_t xStreamBufferBytesAvailable(StreamBufferHandle_t xStreamBuffer)
+{
+    size_t count = xStreamBuffer->length + xStreamBuffer->head - xStreamBuffer->tail;
+
+    return (count >= xStreamBuffer->length) ? (count - xStreamBuffer->length) : count;
+}
+
+size_t xStreamBufferSpacesAvailable(StreamBufferHandle_t xStreamBuffer)
+{
+    return xStreamBuffer->length - 1 - xStreamBufferBytesAvailable(xStreamBuffer);
+}
+
+size_t xStreamBufferSend(StreamBufferHandle_t xStreamBuffer, const void *pvTxData,
+                         size_t xDataLengthBytes, TickType_t xTicksToWait)
+{
+    size_t space;
+    size_t first;
+
+    //FreeRTOS only masks to check for space and register as a waiter
+    if (xTicksToWait != 0) {
+        MockMaskBegin();
+        space = xStreamBufferSpacesAvailable(xStreamBuffer);
+        MockMaskEnd();
+        if (space < xDataLengthBytes) {
+            MockWait(MockStreamHasSpace, xStreamBuffer, MockTicksToDeadline(xTicksToWait));
+        }
+    }
+    //The copy itself runs with interrupts on. A stream buffer takes what fits
+    space = xStreamBufferSpacesAvailable(xStreamBuffer);
+    if (xDataLengthBytes > space) {
+        xDataLengthBytes = space;
+    }
+    first = xStreamBuffer->length - xStreamBuffer->head;
+    if (first > xDataLengthBytes) {
+        first = xDataLengthBytes;
+    }
+    memcpy(&xStreamBuffer->storage[xStreamBuffer->head], pvTxData, first);
+    memcpy(xStreamBuffer->storage, (const uint8_t *)pvTxData + first, xDataLengthBytes - first);
+    xStreamBuffer->head = (xStreamBuffer->head + xDataLengthBytes) % xStreamBuffer->length;
+    //Waking a reader suspends the scheduler, it doesn't mask interrupts
+    return xDataLengthBytes;
+}
+
+size_t xStreamBufferReceiveFromISR(StreamBufferHandle_t xStreamBuffer, void *pvRxData,
+                                   size_t xBufferLengthBytes,
+                                   BaseType_t *pxHigherPriorityTaskWoken)
+{
+    size_t count = xStreamBufferBytesAvailable(xStreamBuffer);
+    size_t first;
+
+    if (xBufferLengthBytes > count) {
+        xBufferLengthBytes = count;
+    }
+    first = xStreamBuffer->length - xStreamBuffer->tail;
+    if (first > xBufferLengthBytes) {
+        first = xBufferLengthBytes;
+    }
+    memcpy(pvRxData, &xStreamBuffer->storage[xStreamBuffer->tail], first);
+    memcpy((uint8_t *)pvRxData + first, xStreamBuffer->storage, xBufferLengthBytes - first);
+    xStreamBuffer->tail = (xStreamBuffer->tail + xBufferLengthBytes) % xStreamBuffer->length;
+    if (xBufferLengthBytes != 0) {
+        //Masked only to check for a writer waiting on space
+        MockMaskBegin();
+        if (pxHigherPriorityTaskWoken != NULL) {
+            *pxHigherPriorityTaskWoken = pdFALSE;
+        }
+        MockMaskEnd();
+    }
+    return xBufferLengthBytes;
+}
+
+BaseType_t xStreamBufferReset(StreamBufferHandle_t xStreamBuffer)
+{
+    taskENTER_CRITICAL();
+    xStreamBuffer->head = 0;
+    xStreamBuffer->tail = 0;
+    taskEXIT_CRITICAL();
+    return pdPASS;
+}
+
+/**
+ * Coroutine entry. Task functions never return on the target either
+ */
+void MockTaskEntry()
+{
+    current->fn(current->param);
+    fprintf(stderr, "Mock kernel: task %s returned\n", current->name);
+    abort();
+}
+
+/**
+ * Decides whether a task can be dispatched now, and if it was waiting, why
+ * it wakes
+ */
+bool MockTaskCanRun(struct tskTaskControlBlock *t)
+{
+    if (t->stallUntil > now) {
+        return false;
+    }
+    if (!t->waiting) {
+        return true;
+    }
+    if ((t->ready != NULL) && t->ready(t->readyArg)) {
+        t->met = true;
+        return true;
+    }
+    if (now >= t->deadline) {
+        t->met = false;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Picks the highest priority task that can run, oldest dispatch first among
+ * equals
+ * @returns The task, NULL if none can run
+ */
+struct tskTaskControlBlock *MockPickTask()
+{
+    struct tskTaskControlBlock *best = NULL;
+    int i;
+
+    for (i = 0; i < numTasks; i++) {
+        if (!MockTaskCanRun(tasks[i])) {
+            continue;
+        }
+        if ((best == NULL) || (tasks[i]->prio > best->prio) ||
+            ((tasks[i]->prio == best->prio) && (tasks[i]->lastRun < best->lastRun))) {
+            best = tasks[i];
+        }
+    }
+    return best;
+}
+
+/**
+ * Gets the next time something can change: an event, a timeout or the end of
+ * a stall
+ */
+uint64_t MockNextTime()
+{
+    uint64_t next = MOCK_FOREVER;
+    int i;
+
+    while ((numEvents > 0) && (events[0].fn == NULL)) {
+        MockEventPop();
+    }
+    if (numEvents > 0) {
+        next = events[0].when;
+    }
+    for (i = 0; i < numTasks; i++) {
+        if (tasks[i]->stallUntil > now) {
+            if (tasks[i]->stallUntil < next) {
+                next = tasks[i]->stallUntil;
+            }
+        } else if (tasks[i]->waiting && (tasks[i]->deadline < next)) {
+            next = tasks[i]->deadline;
+        }
+    }
+    return next;
+}
+
+/**
+ * Runs the handlers of every event that is due, in interrupt context
+ */
+void MockRunDueEvents()
+{
+    mock_event_t ev;
+
+    while ((numEvents > 0) && (events[0].when <= now)) {
+        ev = events[0];
+        MockEventPop();
+        if (ev.fn != NULL) {
+            inInterrupt = true;
+            ev.fn(ev.arg);
+            inInterrupt = false;
+        }
+    }
+}
+
+bool MockEventBefore(const mock_event_t *a, const mock_event_t *b)
+{
+    return (a->when < b->when) || ((a->when == b->when) && (a->id < b->id));
+}
+
+/**
+ * Removes the earliest event from the heap
+ */
+void MockEventPop()
+{
+    uint32_t i = 0;
+    uint32_t child;
+    mock_event_t tmp;
+
+    events[0] = events[--numEvents];
+    for (;;) {
+        child = 2 * i + 1;
+        if (child >= numEvents) {
+            break;
+        }
+        if (((child + 1) < numEvents) && MockEventBefore(&events[child + 1], &events[child])) {
+            child++;
+        }
+        if (!MockEventBefore(&events[child], &events[i])) {
+            break;
+        }
+        tmp = events[i];
+        events[i] = events[child];
+        events[child] = tmp;
+        i = child;
+    }
+}
+
+/**
+ * Converts a FreeRTOS block time to a deadline. Like the real kernel, a delay
+ * of n ticks ends on the nth tick boundary from now
+ */
+uint64_t MockTicksToDeadline(TickType_t ticks)
+{
+    if (ticks == portMAX_DELAY) {
+        return MOCK_FOREVER;
+    }
+    if (ticks == 0) {
+        return now;
+    }
+    return ((now / MOCK_NS_PER_TICK) + ticks) * MOCK_NS_PER_TICK;
+}
+
+bool MockNotifyPending(void *arg)
+{
+    struct tskTaskControlBlock *t = arg;
+
+    return __atomic_load_n(&t->notify, __ATOMIC_ACQUIRE) != 0;
+}
+
+bool MockQueueHasSpace(void *arg)
+{
+    struct QueueDefinition *q = arg;
+
+    return q->count < q->length;
+}
+
+bool MockQueueHasItems(void *arg)
+{
+    struct QueueDefinition *q = arg;
+
+    return q->count != 0;
+}
+
+bool MockStreamHasSpace(void *arg)
+{
+    //Wakes on any space, the send then takes what fits
+    return xStreamBufferSpacesAvailable(arg) != 0;
+}
+
+/**
+ * Gets the host's monotonic clock, for the masked time accounting
+ */
+uint64_t MockHostNs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
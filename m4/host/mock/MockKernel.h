@@ -0,0 +1,141 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_MOCKKERNEL_H_
+#define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_MOCKKERNEL_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Host stand-in for the FreeRTOS kernel and the interrupt controller, in
+ * virtual time. The target runs FreeRTOS cooperatively (configUSE_PREEMPTION
+ * 0), so tasks here are coroutines on one host thread: a task runs until it
+ * blocks, and then the highest priority task that can run goes next. Task
+ * code takes no virtual time.
+ *
+ * Interrupts are events scheduled at a virtual time. When no task can run the
+ * clock jumps to the next event or timeout, and the event's handler runs in
+ * interrupt context, where the FromISR calls are used. Handlers only run
+ * between tasks, just as an ISR that a task never notices.
+ *
+ * Times are nanoseconds since the scheduler started.
+ */
+
+#define MOCK_NS_PER_TICK 1000000ULL
+#define MOCK_FOREVER UINT64_MAX
+
+typedef void (*mock_event_fn_t)(void *arg);
+typedef bool (*mock_ready_fn_t)(void *arg);
+
+/**
+ * Gets the current virtual time
+ * @returns Nanoseconds
+ */
+uint64_t MockNow(void);
+
+/**
+ * Schedules an interrupt handler. Events at the same time run in the order
+ * they were scheduled
+ * @param when - Virtual time to run at. Past times run at the next chance
+ * @param fn - Handler, runs in interrupt context
+ * @param arg - Passed to the handler
+ * @returns Event id, for MockCancel
+ */
+uint32_t MockAt(uint64_t when, mock_event_fn_t fn, void *arg);
+
+/**
+ * Cancels a scheduled event. Does nothing if it already ran
+ * @param id - Event id from MockAt
+ */
+void MockCancel(uint32_t id);
+
+/**
+ * Blocks the calling task until ready(arg) is true or the deadline passes.
+ * Task context only. This is what the FreeRTOS calls and the driver mocks
+ * block with
+ * @param ready - Condition, NULL to just sleep until the deadline
+ * @param arg - Passed to ready
+ * @param deadline - Virtual time to give up at, MOCK_FOREVER for none
+ * @returns true if the condition was met, false on timeout
+ */
+bool MockWait(mock_ready_fn_t ready, void *arg, uint64_t deadline);
+
+/**
+ * Marks a section the target runs with interrupts masked: taskENTER_CRITICAL,
+ * and the parts of the queue and stream buffer calls that FreeRTOS masks.
+ * Sections nest, and their host time is added up
+ */
+void MockMaskBegin(void);
+void MockMaskEnd(void);
+
+/**
+ * Gets the host time spent in masked sections so far. It shows where the
+ * target masks and how much work sits inside, not how long that takes on the
+ * M4
+ * @returns Host nanoseconds
+ */
+uint64_t MockMaskedNs(void);
+
+/**
+ * Makes vTaskStartScheduler return once virtual time reaches a point
+ * @param when - Virtual time to stop at
+ */
+void MockStopAt(uint64_t when);
+
+/**
+ * Makes vTaskStartScheduler return as soon as the running task blocks
+ */
+void MockStop(void);
+
+/**
+ * Lets the scheduler idle, instead of reporting a deadlock, when every task
+ * waits forever. For tests where host threads (not tasks) wake the tasks.
+ * @param enable - true while such threads are running
+ */
+void MockExternalWakers(bool enable);
+
+/**
+ * Stalls a task as if something held the CPU: it is not run again until the
+ * given time, whatever it is waiting for. Models a task hogging the CPU or a
+ * long critical section
+ * @param name - Task name, as given to xTaskCreate
+ * @param until - Virtual time it may run again
+ * @returns false if there is no such task
+ */
+bool MockStallTask(const char *name, uint64_t until);
+
+/**
+ * Seeds the random numbers the mocks draw jitter and faults from, so a run
+ * can be repeated exactly
+ * @param seed - Any non zero value
+ */
+void MockSeed(uint32_t seed);
+
+/**
+ * Gets a pseudo random number
+ * @returns 32 random bits
+ */
+uint32_t MockRandom(void);
+
+/**
+ * Gets whether the caller is running as an interrupt handler
+ * @returns true in interrupt context
+ */
+bool MockInInterrupt(void);
+
+#endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_MOCKKERNEL_H_
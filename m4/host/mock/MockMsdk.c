@@ -0,0 +1,525 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "MockMsdk.h"
+#include "MockKernel.h"
+
+#include "mxc_device.h"
+#include "mxc_errors.h"
+#include "mxc_sys.h"
+#include "mcr_regs.h"
+#include "nvic_table.h"
+#include "dma.h"
+#include "i2s.h"
+#include "i2c.h"
+#include "uart.h"
+
+#define MOCK_NS_PER_SEC 1000000000ULL
+
+/* The one DMA channel the I2S RX side gets */
+#define MOCK_I2S_DMA_CH 0
+
+/* MAX9867 clocking, as set up by Codec.c */
+#define MOCK_CODEC_PCLK 12288000.0
+#define MOCK_CODEC_REG_NI_HI 0x06
+#define MOCK_CODEC_REG_NI_LO 0x07
+#define MOCK_CODEC_REG_DHF 0x0A
+#define MOCK_CODEC_REG_PWR 0x17
+#define MOCK_CODEC_DHF 0x08
+#define MOCK_CODEC_NSHDN 0x80
+
+/* 100kHz, so 10us a bit. A byte and its ack are 9 bits, plus start and stop */
+#define MOCK_I2C_BIT_NS 10000ULL
+#define MOCK_I2C_LOG_SIZE 64
+
+uint32_t SystemCoreClock = IPO_FREQ;
+mxc_mcr_regs_t mockMcrRegs;
+mxc_i2c_regs_t mockI2cRegs[3];
+mxc_uart_regs_t mockUartRegs[4];
+
+/* Codec frame clock. Position is linear in time between register changes */
+static double clockPpm;
+static double clockRate; /**< Frames per ns, 0 while in shutdown */
+static uint64_t clockT0;
+static double clockPos0;
+
+/* I2S and its DMA channel */
+static mxc_i2s_req_t i2sConfig;
+static void (*dmaCallback)(int, int);
+static mock_i2s_source_t i2sSource;
+static void *i2sSourceArg;
+static struct {
+    bool active;
+    uint8_t *buf;
+    uint32_t len;
+    uint64_t endFrame; /**< Clock position the current transfer ends at */
+    bool reload;
+    uint8_t *reloadBuf;
+    uint32_t reloadLen;
+    uint32_t event; /**< Completion event, 0 if none */
+} dma;
+static uint32_t isrDelayMaxNs;
+static uint32_t isrDelayPermille;
+static mock_dma_stats_t dmaStats;
+
+/* I2C and the codec behind it */
+static uint8_t codecRegs[MOCK_CODEC_NUM_REGS];
+static mxc_i2c_req_t *i2cActive;
+static uint8_t i2cData[MOCK_CODEC_NUM_REGS + 1];
+static uint32_t i2cEvent;
+static uint32_t i2cCount;
+static mock_i2c_xfer_t i2cLog[MOCK_I2C_LOG_SIZE];
+
+/* Console UART */
+static mock_uart_sink_t uartSink;
+static void *uartSinkArg;
+static bool uartSinkSet;
+static uint32_t uartBaud = 115200;
+static mxc_uart_req_t *uartActive;
+
+static double MockClockPos(uint64_t t);
+static void MockClockUpdate(void);
+static uint32_t MockFrameBytes(void);
+static void MockDmaSchedule(void);
+static void MockDmaComplete(void *arg);
+static void MockDmaCallback(void *arg);
+static void MockDmaFill(uint8_t *buf, uint32_t len, uint64_t frame);
+static void MockI2cComplete(void *arg);
+static void MockUartComplete(void *arg);
+
+//--------------------------------------------------------------------+
+// Harness side
+//--------------------------------------------------------------------+
+void MockI2sSetSource(mock_i2s_source_t source, void *arg)
+{
+    i2sSource = source;
+    i2sSourceArg = arg;
+}
+
+void MockI2sSetClockPpm(double ppm)
+{
+    clockPpm = ppm;
+    MockClockUpdate();
+}
+
+double MockI2sFramePos()
+{
+    return MockClockPos(MockNow());
+}
+
+double MockI2sFrameRate()
+{
+    return clockRate * MOCK_NS_PER_SEC;
+}
+
+void MockDmaSetIsrDelay(uint32_t maxNs, uint32_t permille)
+{
+    isrDelayMaxNs = maxNs;
+    isrDelayPermille = permille;
+}
+
+void MockDmaGetStats(mock_dma_stats_t *stats)
+{
+    *stats = dmaStats;
+}
+
+uint32_t MockI2cTransactions()
+{
+    return i2cCount;
+}
+
+uint32_t MockI2cLog(mock_i2c_xfer_t *log, uint32_t max)
+{
+    uint32_t kept = (i2cCount < MOCK_I2C_LOG_SIZE) ? i2cCount : MOCK_I2C_LOG_SIZE;
+    uint32_t i;
+
+    if (max > kept) {
+        max = kept;
+    }
+    for (i = 0; i < max; i++) {
+        log[i] = i2cLog[(i2cCount - max + i) % MOCK_I2C_LOG_SIZE];
+    }
+    return max;
+}
+
+uint8_t MockCodecReg(uint8_t reg)
+{
+    return (reg < MOCK_CODEC_NUM_REGS) ? codecRegs[reg] : 0;
+}
+
+void MockUartSetSink(mock_uart_sink_t sink, void *arg)
+{
+    uartSink = sink;
+    uartSinkArg = arg;
+    uartSinkSet = true;
+}
+
+//--------------------------------------------------------------------+
+// System, NVIC
+//--------------------------------------------------------------------+
+int MXC_SYS_ClockSourceEnable(mxc_sys_system_clock_t clock)
+{
+    (void)clock;
+    return E_NO_ERROR;
+}
+
+void MXC_SYS_ClockEnable(mxc_sys_periph_clock_t clock)
+{
+    (void)clock;
+}
+
+void MXC_SYS_Reset_Periph(mxc_sys_reset_t reset)
+{
+    (void)reset;
+}
+
+void MXC_NVIC_SetVector(IRQn_Type irqn, void (*irq_callback)(void))
+{
+    //Handlers are called directly by the mocks
+    (void)irqn;
+    (void)irq_callback;
+}
+
+//--------------------------------------------------------------------+
+// I2S and DMA
+//--------------------------------------------------------------------+
+int MXC_I2S_Init(mxc_i2s_req_t *req)
+{
+    if ((req == NULL) || (req->rxData == NULL) || (req->length == 0)) {
+        return E_BAD_PARAM;
+    }
+    i2sConfig = *req;
+    return E_NO_ERROR;
+}
+
+void MXC_I2S_RegisterDMACallback(void (*callback)(int, int))
+{
+    dmaCallback = callback;
+}
+
+int MXC_I2S_RXDMAConfig(void *dest, int len)
+{
+    uint32_t frames;
+
+    if (dma.active || (len <= 0) || ((uint32_t)len % MockFrameBytes()) != 0) {
+        return E_BAD_STATE;
+    }
+    frames = (uint32_t)len / MockFrameBytes();
+    dma.active = true;
+    dma.buf = dest;
+    dma.len = (uint32_t)len;
+    dma.reload = false;
+    //Capture starts with the next whole frame
+    dma.endFrame = (uint64_t)ceil(MockI2sFramePos()) + frames;
+    MockDmaSchedule();
+    return MOCK_I2S_DMA_CH;
+}
+
+void MXC_I2S_RXDisable()
+{
+    MXC_DMA_Stop(MOCK_I2S_DMA_CH);
+}
+
+void MXC_I2S_Flush()
+{
+}
+
+int MXC_DMA_SetSrcReload(mxc_dma_srcdst_t srcdst)
+{
+    if ((srcdst.ch != MOCK_I2S_DMA_CH) || !dma.active) {
+        return E_BAD_PARAM;
+    }
+    dma.reloadBuf = srcdst.dest;
+    dma.reloadLen = (uint32_t)srcdst.len;
+    dma.reload = true;
+    return E_NO_ERROR;
+}
+
+int MXC_DMA_Stop(int ch)
+{
+    if (ch != MOCK_I2S_DMA_CH) {
+        return E_BAD_PARAM;
+    }
+    dma.active = false;
+    dma.reload = false;
+    if (dma.event != 0) {
+        MockCancel(dma.event);
+        dma.event = 0;
+    }
+    return E_NO_ERROR;
+}
+
+int MXC_DMA_ReleaseChannel(int ch)
+{
+    return (ch == MOCK_I2S_DMA_CH) ? E_NO_ERROR : E_BAD_PARAM;
+}
+
+void MXC_DMA_Handler()
+{
+}
+
+/**
+ * Gets the codec clock position at a time in the current clock segment
+ */
+double MockClockPos(uint64_t t)
+{
+    return clockPos0 + (double)(t - clockT0) * clockRate;
+}
+
+/**
+ * Starts a new clock segment after a register or ppm change, and moves the
+ * DMA completion to match
+ */
+void MockClockUpdate()
+{
+    uint32_t ni = ((uint32_t)(codecRegs[MOCK_CODEC_REG_NI_HI] & 0x7F) << 8) |
+                  codecRegs[MOCK_CODEC_REG_NI_LO];
+    double mult = (codecRegs[MOCK_CODEC_REG_DHF] & MOCK_CODEC_DHF) ? 48.0 : 96.0;
+    uint64_t now = MockNow();
+
+    clockPos0 = MockClockPos(now);
+    clockT0 = now;
+    clockRate = 0;
+    if (codecRegs[MOCK_CODEC_REG_PWR] & MOCK_CODEC_NSHDN) {
+        clockRate = ((ni * MOCK_CODEC_PCLK) / (65536.0 * mult)) * (1.0 + clockPpm / 1e6) /
+                    MOCK_NS_PER_SEC;
+    }
+    MockDmaSchedule();
+}
+
+/**
+ * Gets the bytes one frame takes in the DMA buffers
+ */
+uint32_t MockFrameBytes()
+{
+    uint32_t width = (i2sConfig.wordSize == MXC_I2S_DATASIZE_WORD) ? 4 : 2;
+    uint32_t channels = (i2sConfig.stereoMode == MXC_I2S_STEREO) ? 2 : 1;
+
+    return width * channels;
+}
+
+/**
+ * (Re)schedules the completion of the current transfer for when the clock
+ * gets to its end. Nothing completes while the clock is stopped
+ */
+void MockDmaSchedule()
+{
+    uint64_t now = MockNow();
+    double pos = MockClockPos(now);
+    uint64_t when = now;
+
+    if (dma.event != 0) {
+        MockCancel(dma.event);
+        dma.event = 0;
+    }
+    if (!dma.active || (clockRate <= 0)) {
+        return;
+    }
+    if ((double)dma.endFrame > pos) {
+        when += (uint64_t)ceil(((double)dma.endFrame - pos) / clockRate);
+    }
+    dma.event = MockAt(when, MockDmaComplete, NULL);
+}
+
+/**
+ * The DMA reached the end of a transfer. The buffer is filled with what the
+ * codec sent meanwhile, the channel moves on to the reload and the
+ * completion interrupt fires
+ */
+void MockDmaComplete(void *arg)
+{
+    uint32_t frames = dma.len / MockFrameBytes();
+
+    (void)arg;
+    dma.event = 0;
+    MockDmaFill(dma.buf, dma.len, dma.endFrame - frames);
+    dmaStats.completions++;
+    if (dma.reload) {
+        dma.buf = dma.reloadBuf;
+        dma.len = dma.reloadLen;
+        dma.reload = false;
+        dma.endFrame += dma.len / MockFrameBytes();
+        MockDmaSchedule();
+    } else {
+        //Nothing to go on to, the channel stops and the I2S FIFO overflows
+        dmaStats.starved++;
+        dma.active = false;
+    }
+
+    if ((isrDelayPermille != 0) && ((MockRandom() % 1000) < isrDelayPermille)) {
+        dmaStats.delayed++;
+        MockAt(MockNow() + (MockRandom() % (isrDelayMaxNs + 1)), MockDmaCallback, NULL);
+    } else {
+        MockDmaCallback(NULL);
+    }
+}
+
+void MockDmaCallback(void *arg)
+{
+    (void)arg;
+    if (dmaCallback != NULL) {
+        dmaCallback(MOCK_I2S_DMA_CH, E_NO_ERROR);
+    }
+}
+
+/**
+ * Fills a DMA buffer from the source, in the I2S word format
+ */
+void MockDmaFill(uint8_t *buf, uint32_t len, uint64_t frame)
+{
+    uint32_t channels = (i2sConfig.stereoMode == MXC_I2S_STEREO) ? 2 : 1;
+    uint32_t frames = len / MockFrameBytes();
+    int32_t samples[2] = { 0, 0 };
+    int16_t *out16 = (int16_t *)buf;
+    int32_t *out32 = (int32_t *)buf;
+    uint32_t shift = 32 - (uint32_t)i2sConfig.sampleSize;
+    uint32_t i;
+    uint32_t ch;
+
+    for (i = 0; i < frames; i++, frame++) {
+        if (i2sSource != NULL) {
+            i2sSource(frame, samples, channels, i2sSourceArg);
+        }
+        for (ch = 0; ch < channels; ch++) {
+            if (i2sConfig.wordSize == MXC_I2S_DATASIZE_WORD) {
+                //MSB aligned in the word
+                *out32++ = (int32_t)((uint32_t)samples[ch] << shift);
+            } else {
+                *out16++ = (int16_t)samples[ch];
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------+
+// I2C, with the codec on it
+//--------------------------------------------------------------------+
+int MXC_I2C_MasterTransactionAsync(mxc_i2c_req_t *req)
+{
+    mock_i2c_xfer_t *entry;
+    uint32_t bytes;
+
+    if (i2cActive != NULL) {
+        return E_BUSY;
+    }
+    if ((req->tx_len == 0) || (req->tx_len > sizeof(i2cData)) || (req->rx_len != 0)) {
+        return E_BAD_PARAM;
+    }
+    //The bytes go out as the transaction runs, take them now
+    memcpy(i2cData, req->tx_buf, req->tx_len);
+    entry = &i2cLog[i2cCount % MOCK_I2C_LOG_SIZE];
+    entry->when = MockNow();
+    entry->addr = req->addr;
+    entry->reg = req->tx_buf[0];
+    entry->len = req->tx_len;
+    i2cCount++;
+
+    i2cActive = req;
+    bytes = req->tx_len + 1; //And the address
+    i2cEvent = MockAt(MockNow() + ((bytes * 9) + 2) * MOCK_I2C_BIT_NS, MockI2cComplete, NULL);
+    return E_NO_ERROR;
+}
+
+int MXC_I2C_AbortAsync(mxc_i2c_req_t *req)
+{
+    if (i2cActive != req) {
+        return E_BAD_PARAM;
+    }
+    MockCancel(i2cEvent);
+    i2cActive = NULL;
+    return E_NO_ERROR;
+}
+
+void MXC_I2C_AsyncHandler(mxc_i2c_regs_t *i2c)
+{
+    (void)i2c;
+}
+
+/**
+ * End of a transaction. Codec writes auto-increment the register address
+ * from the first byte
+ */
+void MockI2cComplete(void *arg)
+{
+    mxc_i2c_req_t *req = i2cActive;
+    uint32_t reg;
+    uint32_t i;
+
+    (void)arg;
+    i2cActive = NULL;
+    if (req->addr == MOCK_CODEC_ADDR) {
+        reg = i2cData[0];
+        for (i = 1; (i < req->tx_len) && (reg < MOCK_CODEC_NUM_REGS); i++, reg++) {
+            codecRegs[reg] = i2cData[i];
+        }
+        MockClockUpdate();
+    }
+    if (req->callback != NULL) {
+        req->callback(req, E_NO_ERROR);
+    }
+}
+
+//--------------------------------------------------------------------+
+// UART
+//--------------------------------------------------------------------+
+int MXC_UART_SetFrequency(mxc_uart_regs_t *uart, unsigned int baud, mxc_uart_clock_t clock)
+{
+    (void)uart;
+    (void)clock;
+    uartBaud = baud;
+    return (int)baud;
+}
+
+int MXC_UART_SetAutoDMAHandlers(mxc_uart_regs_t *uart, bool enable)
+{
+    (void)uart;
+    (void)enable;
+    return E_NO_ERROR;
+}
+
+int MXC_UART_TransactionDMA(mxc_uart_req_t *req)
+{
+    if (uartActive != NULL) {
+        return E_BUSY;
+    }
+    if (!uartSinkSet) {
+        fwrite(req->txData, 1, req->txLen, stdout);
+    } else if (uartSink != NULL) {
+        uartSink(req->txData, req->txLen, uartSinkArg);
+    }
+    uartActive = req;
+    //10 bits a character
+    MockAt(MockNow() + ((uint64_t)req->txLen * 10 * MOCK_NS_PER_SEC) / uartBaud, MockUartComplete,
+           NULL);
+    return E_NO_ERROR;
+}
+
+void MockUartComplete(void *arg)
+{
+    mxc_uart_req_t *req = uartActive;
+
+    (void)arg;
+    uartActive = NULL;
+    req->txCnt = req->txLen;
+    if (req->callback != NULL) {
+        req->callback(req, E_NO_ERROR);
+    }
+}
@@ -0,0 +1,138 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_MOCKMSDK_H_
+#define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_MOCKMSDK_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Host stand-ins for the MSDK drivers the firmware uses, on the mock kernel's
+ * virtual clock:
+ *  - I2S RX DMA with reload. Transfers complete at the codec's frame clock,
+ *    and the samples come from a source function set by the harness.
+ *  - The MAX9867 behind the I2C driver. Writes land in a register map after
+ *    the time they would take on a 100kHz bus, and the frame clock follows
+ *    the map: running when out of shutdown, at the rate NI and DHF select.
+ *  - The console UART, which hands the bytes to a sink at the baud rate.
+ */
+
+#define MOCK_CODEC_ADDR 0x18
+#define MOCK_CODEC_NUM_REGS 0x18
+
+/**
+ * Produces one frame of input audio. Values are signed, at the stream's
+ * sample width (16 or 24 bits), and are placed in the DMA's sample format
+ * @param frame - Codec frame number, counted since the clock first started
+ * @param samples - Where to put one value per channel
+ * @param channels - Channels per frame
+ * @param arg - As given to MockI2sSetSource
+ */
+typedef void (*mock_i2s_source_t)(uint64_t frame, int32_t *samples, uint32_t channels, void *arg);
+
+/**
+ * Takes bytes written to the console UART
+ * @param data - The bytes
+ * @param len - How many
+ * @param arg - As given to MockUartSetSink
+ */
+typedef void (*mock_uart_sink_t)(const uint8_t *data, uint32_t len, void *arg);
+
+/** One I2C transaction, as logged by the mock */
+typedef struct {
+    uint64_t when; /**< Virtual time it started */
+    uint8_t addr;
+    uint8_t reg; /**< First byte written, the register address */
+    uint32_t len; /**< Bytes written, address included */
+} mock_i2c_xfer_t;
+
+typedef struct {
+    uint32_t completions; /**< DMA transfers finished */
+    uint32_t starved; /**< Transfers that ended with no reload set */
+    uint32_t delayed; /**< Completion callbacks held back, see MockDmaSetIsrDelay */
+} mock_dma_stats_t;
+
+/**
+ * Sets where the I2S input comes from. Silence until set
+ * @param source - Called once per captured frame, in order
+ * @param arg - Passed to source
+ */
+void MockI2sSetSource(mock_i2s_source_t source, void *arg);
+
+/**
+ * Offsets the codec's clock from nominal, as a crystal would be. The USB
+ * side's clock is the reference
+ * @param ppm - Parts per million, positive is fast
+ */
+void MockI2sSetClockPpm(double ppm);
+
+/**
+ * Gets where the codec's frame clock is now
+ * @returns Frames since the clock first started, with the fraction
+ */
+double MockI2sFramePos(void);
+
+/**
+ * Gets the codec's frame rate, as its registers have it
+ * @returns Frames per second including the ppm offset, 0 if in shutdown
+ */
+double MockI2sFrameRate(void);
+
+/**
+ * Holds back DMA completion callbacks, as a long higher priority interrupt or
+ * critical section would. The DMA itself keeps going
+ * @param maxNs - Longest hold, each is uniformly random up to this
+ * @param permille - Share of completions held back
+ */
+void MockDmaSetIsrDelay(uint32_t maxNs, uint32_t permille);
+
+/**
+ * Gets the DMA counters
+ * @param stats - Filled in
+ */
+void MockDmaGetStats(mock_dma_stats_t *stats);
+
+/**
+ * Gets the number of I2C transactions started since boot
+ * @returns Transaction count
+ */
+uint32_t MockI2cTransactions(void);
+
+/**
+ * Copies out the most recent I2C transactions, oldest first
+ * @param log - Where to put them
+ * @param max - Room in log
+ * @returns Number copied. Only the last 64 are kept
+ */
+uint32_t MockI2cLog(mock_i2c_xfer_t *log, uint32_t max);
+
+/**
+ * Reads the codec's register map
+ * @param reg - Register address
+ * @returns Register value
+ */
+uint8_t MockCodecReg(uint8_t reg);
+
+/**
+ * Sets where console output goes. stdout until set
+ * @param sink - Called as each UART transfer starts, NULL to discard
+ * @param arg - Passed to sink
+ */
+void MockUartSetSink(mock_uart_sink_t sink, void *arg);
+
+#endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_MOCKMSDK_H_
@@ -0,0 +1,348 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#include <string.h>
+
+#include "MockUsb.h"
+#include "MockKernel.h"
+
+#define MOCK_USB_ITF_STREAM 1
+#define MOCK_USB_EP_IN 0x81
+#define MOCK_USB_ENTITY_FU 2
+#define MOCK_USB_ENTITY_CLK 4
+#define MOCK_USB_CTRL_QUEUE 16
+#define MOCK_USB_FIFO_SIZE CFG_TUD_AUDIO_FUNC_1_EP_IN_SW_BUF_SZ
+
+/* A control request waiting for tud_task */
+typedef struct {
+    tusb_control_request_t req;
+    uint8_t data[4];
+} mock_usb_ctrl_t;
+
+static tusb_speed_t speed = TUSB_SPEED_HIGH;
+static mock_usb_sink_t sink;
+static void *sinkArg;
+static uint32_t jitterMaxNs;
+static uint32_t missPermille;
+static mock_usb_stats_t stats;
+
+static bool started;
+static uint64_t nextPoll;
+
+static mock_usb_ctrl_t ctrlQueue[MOCK_USB_CTRL_QUEUE];
+static uint32_t ctrlHead;
+static uint32_t ctrlCount;
+
+/* Streaming endpoint. The FIFO is what tud_audio_write fills, the packet is
+ * what the controller will send at the next poll */
+static bool epOpen;
+static uint8_t fifo[MOCK_USB_FIFO_SIZE];
+static uint32_t fifoCount;
+static uint8_t packet[CFG_TUD_AUDIO_EP_SZ_IN];
+static uint32_t packetLen;
+static bool packetReady;
+static volatile bool xferDone;
+
+static void MockUsbQueueCtrl(const mock_usb_ctrl_t *ctrl);
+static void MockUsbQueueEntity(uint8_t entity, uint8_t ctrlSel, uint8_t channel,
+                               const void *data, uint16_t len);
+static void MockUsbRunCtrl(mock_usb_ctrl_t *ctrl);
+static void MockUsbTxDone(void);
+static void MockUsbPoll(void *arg);
+static void MockUsbXferComplete(void *arg);
+static bool MockUsbHasWork(void *arg);
+static uint64_t MockUsbInterval(void);
+static uint32_t MockUsbEpSize(void);
+
+//--------------------------------------------------------------------+
+// Harness side
+//--------------------------------------------------------------------+
+void MockUsbSetSpeed(tusb_speed_t newSpeed)
+{
+    speed = newSpeed;
+}
+
+void MockUsbSetSink(mock_usb_sink_t newSink, void *arg)
+{
+    sink = newSink;
+    sinkArg = arg;
+}
+
+void MockUsbSetStream(bool on)
+{
+    mock_usb_ctrl_t ctrl = { 0 };
+
+    ctrl.req.bmRequestType = 0x01; //Standard, to an interface
+    ctrl.req.bRequest = TUSB_REQ_SET_INTERFACE;
+    ctrl.req.wValue = on ? 1 : 0;
+    ctrl.req.wIndex = MOCK_USB_ITF_STREAM;
+    MockUsbQueueCtrl(&ctrl);
+}
+
+void MockUsbSetSampleRate(uint32_t rate)
+{
+    audio_control_cur_4_t cur = { .bCur = (int32_t)rate };
+
+    MockUsbQueueEntity(MOCK_USB_ENTITY_CLK, AUDIO_CS_CTRL_SAM_FREQ, 0, &cur, sizeof(cur));
+}
+
+void MockUsbSetVolume(uint8_t channel, int16_t volume)
+{
+    audio_control_cur_2_t cur = { .bCur = volume };
+
+    MockUsbQueueEntity(MOCK_USB_ENTITY_FU, AUDIO_FU_CTRL_VOLUME, channel, &cur, sizeof(cur));
+}
+
+void MockUsbSetMute(uint8_t channel, bool mute)
+{
+    audio_control_cur_1_t cur = { .bCur = mute ? 1 : 0 };
+
+    MockUsbQueueEntity(MOCK_USB_ENTITY_FU, AUDIO_FU_CTRL_MUTE, channel, &cur, sizeof(cur));
+}
+
+void MockUsbSetJitter(uint32_t maxNs)
+{
+    jitterMaxNs = maxNs;
+}
+
+void MockUsbSetMissRate(uint32_t permille)
+{
+    missPermille = permille;
+}
+
+void MockUsbGetStats(mock_usb_stats_t *out)
+{
+    *out = stats;
+}
+
+//--------------------------------------------------------------------+
+// Device stack
+//--------------------------------------------------------------------+
+bool tud_init(uint8_t rhport)
+{
+    (void)rhport;
+    if (!started) {
+        //Polls line up with the bus's service intervals
+        started = true;
+        nextPoll = ((MockNow() / MockUsbInterval()) + 1) * MockUsbInterval();
+        MockAt(nextPoll, MockUsbPoll, NULL);
+    }
+    return true;
+}
+
+void tud_task()
+{
+    mock_usb_ctrl_t ctrl;
+
+    MockWait(MockUsbHasWork, NULL, MOCK_FOREVER);
+    while (ctrlCount > 0) {
+        ctrl = ctrlQueue[ctrlHead];
+        ctrlHead = (ctrlHead + 1) % MOCK_USB_CTRL_QUEUE;
+        ctrlCount--;
+        MockUsbRunCtrl(&ctrl);
+    }
+    if (xferDone) {
+        xferDone = false;
+        if (epOpen) {
+            MockUsbTxDone();
+        }
+    }
+}
+
+void tud_int_handler(uint8_t rhport)
+{
+    (void)rhport;
+}
+
+tusb_speed_t tud_speed_get()
+{
+    return speed;
+}
+
+bool tud_control_xfer(uint8_t rhport, tusb_control_request_t const *request, void *buffer,
+                      uint16_t len)
+{
+    (void)rhport;
+    (void)request;
+    (void)buffer;
+    (void)len;
+    return true;
+}
+
+bool tud_audio_buffer_and_schedule_control_xfer(uint8_t rhport,
+                                                tusb_control_request_t const *p_request,
+                                                void *data, uint16_t len)
+{
+    return tud_control_xfer(rhport, p_request, data, len);
+}
+
+uint16_t tud_audio_write(const void *data, uint16_t len)
+{
+    uint16_t n = len;
+
+    if (n > (MOCK_USB_FIFO_SIZE - fifoCount)) {
+        n = (uint16_t)(MOCK_USB_FIFO_SIZE - fifoCount);
+        stats.fifoOverflows++;
+    }
+    memcpy(&fifo[fifoCount], data, n);
+    fifoCount += n;
+    return n;
+}
+
+void MockUsbQueueCtrl(const mock_usb_ctrl_t *ctrl)
+{
+    if (ctrlCount == MOCK_USB_CTRL_QUEUE) {
+        stats.controlFailures++;
+        return;
+    }
+    ctrlQueue[(ctrlHead + ctrlCount) % MOCK_USB_CTRL_QUEUE] = *ctrl;
+    ctrlCount++;
+}
+
+/**
+ * Queues a class specific SET CUR to an entity of the audio control interface
+ */
+void MockUsbQueueEntity(uint8_t entity, uint8_t ctrlSel, uint8_t channel, const void *data,
+                        uint16_t len)
+{
+    mock_usb_ctrl_t ctrl = { 0 };
+
+    ctrl.req.bmRequestType = 0x21; //Class, to an interface
+    ctrl.req.bRequest = AUDIO_CS_REQ_CUR;
+    ctrl.req.wValue = (uint16_t)((ctrlSel << 8) | channel);
+    ctrl.req.wIndex = (uint16_t)(entity << 8); //Audio control interface 0
+    ctrl.req.wLength = len;
+    memcpy(ctrl.data, data, len);
+    MockUsbQueueCtrl(&ctrl);
+}
+
+/**
+ * Runs a control request the way the audio class driver does
+ */
+void MockUsbRunCtrl(mock_usb_ctrl_t *ctrl)
+{
+    bool ok = true;
+
+    if (ctrl->req.bRequest == TUSB_REQ_SET_INTERFACE) {
+        //Any alternate setting closes the endpoint of the one before
+        if (epOpen) {
+            epOpen = false;
+            fifoCount = 0;
+            packetReady = false;
+            ok = tud_audio_set_itf_close_EP_cb(0, &ctrl->req);
+        }
+        ok = tud_audio_set_itf_cb(0, &ctrl->req) && ok;
+        if (ctrl->req.wValue != 0) {
+            //The first packet is scheduled straight away
+            epOpen = true;
+            MockUsbTxDone();
+        }
+    } else {
+        ok = tud_audio_set_req_entity_cb(0, &ctrl->req, ctrl->data);
+    }
+    if (!ok) {
+        stats.controlFailures++;
+    }
+}
+
+/**
+ * The endpoint is free for the next packet: let the application fill the
+ * FIFO, and schedule what fits in one packet
+ */
+void MockUsbTxDone()
+{
+    uint32_t n;
+
+    tud_audio_tx_done_pre_load_cb(0, MOCK_USB_ITF_STREAM, MOCK_USB_EP_IN, 1);
+    n = (fifoCount < MockUsbEpSize()) ? fifoCount : MockUsbEpSize();
+    memcpy(packet, fifo, n);
+    memmove(fifo, &fifo[n], fifoCount - n);
+    fifoCount -= n;
+    packetLen = n;
+    packetReady = true;
+    if (fifoCount != 0) {
+        stats.fifoLeftovers++;
+    }
+    tud_audio_tx_done_post_load_cb(0, (uint16_t)n, MOCK_USB_ITF_STREAM, MOCK_USB_EP_IN, 1);
+}
+
+//--------------------------------------------------------------------+
+// Bus and host
+//--------------------------------------------------------------------+
+/**
+ * One service interval of the IN endpoint
+ */
+void MockUsbPoll(void *arg)
+{
+    (void)arg;
+    nextPoll += MockUsbInterval();
+    MockAt(nextPoll, MockUsbPoll, NULL);
+    if (!epOpen) {
+        return;
+    }
+    stats.polls++;
+    if ((missPermille != 0) && ((MockRandom() % 1000) < missPermille)) {
+        stats.missedPolls++;
+        return;
+    }
+    if (!packetReady) {
+        stats.emptyPolls++;
+        if (sink != NULL) {
+            sink(packet, 0, sinkArg);
+        }
+        return;
+    }
+    packetReady = false;
+    stats.packets++;
+    stats.bytes += packetLen;
+    if (packetLen > stats.maxPacket) {
+        stats.maxPacket = packetLen;
+    }
+    if (sink != NULL) {
+        sink(packet, packetLen, sinkArg);
+    }
+    if (jitterMaxNs != 0) {
+        MockAt(MockNow() + (MockRandom() % (jitterMaxNs + 1)), MockUsbXferComplete, NULL);
+    } else {
+        MockUsbXferComplete(NULL);
+    }
+}
+
+void MockUsbXferComplete(void *arg)
+{
+    (void)arg;
+    xferDone = true;
+}
+
+bool MockUsbHasWork(void *arg)
+{
+    (void)arg;
+    return (ctrlCount > 0) || xferDone;
+}
+
+/**
+ * Gets the time between polls of the IN endpoint
+ */
+uint64_t MockUsbInterval()
+{
+    return (speed == TUSB_SPEED_HIGH) ? (AUDIO_USB_INTERVAL_UFRAMES * 125000ULL) : 1000000ULL;
+}
+
+uint32_t MockUsbEpSize()
+{
+    return (speed == TUSB_SPEED_HIGH) ? CFG_TUD_AUDIO_EP_SZ_IN_HS : CFG_TUD_AUDIO_EP_SZ_IN_FS;
+}
@@ -0,0 +1,121 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_MOCKUSB_H_
+#define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_MOCKUSB_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "tusb.h"
+
+/**
+ * Host stand-in for TinyUSB's device stack and audio class, and for the USB
+ * host on the other end, on the mock kernel's virtual clock.
+ *
+ * The host polls the IN endpoint once per service interval (1ms at full
+ * speed, AUDIO_USB_INTERVAL_UFRAMES microframes at high speed). A poll takes
+ * the packet the stack had scheduled, hands it to the sink, and signals the
+ * transfer complete. tud_task then does what the audio class does: calls the
+ * pre load callback, schedules the next packet out of the endpoint FIFO, and
+ * calls the post load callback. A poll that finds nothing scheduled is an
+ * empty poll, which the host sees as a packet of no data.
+ *
+ * Control requests from the harness are queued and run from tud_task through
+ * the same class callbacks as on the target.
+ */
+
+/**
+ * Takes each isochronous packet the host received
+ * @param data - Packet payload
+ * @param len - Payload bytes, may be 0 on an empty poll
+ * @param arg - As given to MockUsbSetSink
+ */
+typedef void (*mock_usb_sink_t)(const uint8_t *data, uint32_t len, void *arg);
+
+typedef struct {
+    uint32_t polls; /**< Polls of the open endpoint */
+    uint32_t packets; /**< Packets received */
+    uint64_t bytes; /**< Payload bytes received */
+    uint32_t emptyPolls; /**< Polls with nothing scheduled */
+    uint32_t missedPolls; /**< Polls the host skipped, see MockUsbSetMissRate */
+    uint32_t maxPacket; /**< Largest payload */
+    uint32_t fifoOverflows; /**< Writes that did not fit the endpoint FIFO */
+    uint32_t fifoLeftovers; /**< Packets that left data behind in the FIFO */
+    uint32_t controlFailures; /**< Control requests the firmware stalled */
+} mock_usb_stats_t;
+
+/**
+ * Sets the speed the bus comes up at. High speed unless changed, call before
+ * the firmware starts
+ * @param speed - TUSB_SPEED_HIGH or TUSB_SPEED_FULL
+ */
+void MockUsbSetSpeed(tusb_speed_t speed);
+
+/**
+ * Sets where received packets go
+ * @param sink - Called on every poll of the open endpoint
+ * @param arg - Passed to sink
+ */
+void MockUsbSetSink(mock_usb_sink_t sink, void *arg);
+
+/**
+ * Queues a SET_INTERFACE on the streaming interface
+ * @param on - true for the streaming alternate setting, false for zero bandwidth
+ */
+void MockUsbSetStream(bool on);
+
+/**
+ * Queues a SET CUR of the clock source's sample rate
+ * @param rate - Sample rate in Hz
+ */
+void MockUsbSetSampleRate(uint32_t rate);
+
+/**
+ * Queues a SET CUR of a feature unit volume
+ * @param channel - 0 for master, else the channel
+ * @param volume - 1/256 dB
+ */
+void MockUsbSetVolume(uint8_t channel, int16_t volume);
+
+/**
+ * Queues a SET CUR of a feature unit mute
+ * @param channel - 0 for master, else the channel
+ * @param mute - true to mute
+ */
+void MockUsbSetMute(uint8_t channel, bool mute);
+
+/**
+ * Delays transfer complete interrupts after a poll, as a slow or shared
+ * interrupt would
+ * @param maxNs - Longest delay, each is uniformly random up to this
+ */
+void MockUsbSetJitter(uint32_t maxNs);
+
+/**
+ * Makes the host skip polls, as if SOFs were lost
+ * @param permille - Share of polls skipped
+ */
+void MockUsbSetMissRate(uint32_t permille);
+
+/**
+ * Gets the counters
+ * @param stats - Filled in
+ */
+void MockUsbGetStats(mock_usb_stats_t *stats);
+
+#endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_MOCKUSB_H_
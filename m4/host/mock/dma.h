@@ -0,0 +1,37 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_DMA_H_
+#define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_DMA_H_
+
+#include "mxc_device.h"
+
+#define MXC_DMA_CH_GET_IRQ(i) ((IRQn_Type)(DMA0_IRQn + (i)))
+
+typedef struct {
+    int ch;
+    void *source;
+    void *dest;
+    int len;
+} mxc_dma_srcdst_t;
+
+int MXC_DMA_SetSrcReload(mxc_dma_srcdst_t srcdst);
+int MXC_DMA_Stop(int ch);
+int MXC_DMA_ReleaseChannel(int ch);
+void MXC_DMA_Handler(void);
+
+#endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_DMA_H_
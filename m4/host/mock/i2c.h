@@ -0,0 +1,44 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_I2C_H_
+#define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_I2C_H_
+
+#include <stdint.h>
+
+#include "mxc_device.h"
+#include "i2c_regs.h"
+
+typedef struct _i2c_req_t mxc_i2c_req_t;
+typedef void (*mxc_i2c_complete_cb_t)(mxc_i2c_req_t *req, int result);
+
+struct _i2c_req_t {
+    mxc_i2c_regs_t *i2c;
+    uint8_t addr;
+    unsigned char *tx_buf;
+    unsigned int tx_len;
+    unsigned char *rx_buf;
+    unsigned int rx_len;
+    int restart;
+    mxc_i2c_complete_cb_t callback;
+};
+
+int MXC_I2C_MasterTransactionAsync(mxc_i2c_req_t *req);
+int MXC_I2C_AbortAsync(mxc_i2c_req_t *req);
+void MXC_I2C_AsyncHandler(mxc_i2c_regs_t *i2c);
+
+#endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_I2C_H_
@@ -0,0 +1,95 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_I2S_H_
+#define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_I2S_H_
+
+#include <stdint.h>
+
+#include "mxc_device.h"
+
+typedef enum {
+    MXC_I2S_DATASIZE_BYTE,
+    MXC_I2S_DATASIZE_HALFWORD,
+    MXC_I2S_DATASIZE_WORD,
+} mxc_i2s_wsize_t;
+
+typedef enum {
+    MXC_I2S_SAMPLESIZE_EIGHT = 8,
+    MXC_I2S_SAMPLESIZE_SIXTEEN = 16,
+    MXC_I2S_SAMPLESIZE_TWENTY = 20,
+    MXC_I2S_SAMPLESIZE_TWENTYFOUR = 24,
+    MXC_I2S_SAMPLESIZE_THIRTYTWO = 32,
+} mxc_i2s_samplesize_t;
+
+typedef enum {
+    MXC_I2S_ADJUST_LEFT,
+    MXC_I2S_ADJUST_RIGHT,
+} mxc_i2s_adjust_t;
+
+typedef enum {
+    MXC_I2S_MSB_JUSTIFY,
+    MXC_I2S_LSB_JUSTIFY,
+} mxc_i2s_justify_t;
+
+typedef enum {
+    MXC_I2S_POL_NORMAL,
+    MXC_I2S_POL_INVERSE,
+} mxc_i2s_polarity_t;
+
+typedef enum {
+    MXC_I2S_INTERNAL_SCK_WS_0,
+    MXC_I2S_INTERNAL_SCK_WS_1,
+    MXC_I2S_EXTERNAL_SCK_INTERNAL_WS,
+    MXC_I2S_EXTERNAL_SCK_EXTERNAL_WS,
+} mxc_i2s_ch_mode_t;
+
+typedef enum {
+    MXC_I2S_STEREO,
+    MXC_I2S_MONO_LEFT_CH = 2,
+    MXC_I2S_MONO_RIGHT_CH,
+} mxc_i2s_stereo_t;
+
+typedef enum {
+    MXC_I2S_MSB_FIRST,
+    MXC_I2S_LSB_FIRST,
+} mxc_i2s_bitorder_t;
+
+typedef struct {
+    mxc_i2s_ch_mode_t channelMode;
+    mxc_i2s_stereo_t stereoMode;
+    mxc_i2s_wsize_t wordSize;
+    mxc_i2s_justify_t justify;
+    mxc_i2s_bitorder_t bitOrder;
+    mxc_i2s_polarity_t wsPolarity;
+    mxc_i2s_samplesize_t sampleSize;
+    uint16_t clkdiv;
+    mxc_i2s_adjust_t adjust;
+    uint8_t bitsWord;
+    void *rawData;
+    void *txData;
+    void *rxData;
+    uint32_t length;
+} mxc_i2s_req_t;
+
+int MXC_I2S_Init(mxc_i2s_req_t *req);
+void MXC_I2S_RegisterDMACallback(void (*callback)(int, int));
+int MXC_I2S_RXDMAConfig(void *dest, int len);
+void MXC_I2S_RXDisable(void);
+void MXC_I2S_Flush(void);
+
+#endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_I2S_H_
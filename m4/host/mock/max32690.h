@@ -0,0 +1,57 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_MAX32690_H_
+#define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_MAX32690_H_
+
+/* Host stand-in for the MAX32690 device header. Only what the firmware uses */
+
+#include <stdint.h>
+
+#define IPO_FREQ 120000000UL
+#define __NVIC_PRIO_BITS 3
+
+#define MXC_DMA_CHANNELS 16
+
+typedef enum {
+    USB_IRQn,
+    I2C2_IRQn,
+    UART2_IRQn,
+    DMA0_IRQn,
+    MXC_IRQ_COUNT = DMA0_IRQn + MXC_DMA_CHANNELS,
+} IRQn_Type;
+
+extern uint32_t SystemCoreClock;
+
+/* Interrupts are events in the mock kernel, so there is nothing to set up */
+static inline void NVIC_SetPriority(IRQn_Type irq, uint32_t priority)
+{
+    (void)irq;
+    (void)priority;
+}
+
+static inline void NVIC_EnableIRQ(IRQn_Type irq)
+{
+    (void)irq;
+}
+
+static inline void NVIC_DisableIRQ(IRQn_Type irq)
+{
+    (void)irq;
+}
+
+#endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_MAX32690_H_
@@ -0,0 +1,32 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_MCR_REGS_H_
+#define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_MCR_REGS_H_
+
+#include <stdint.h>
+
+typedef struct {
+    volatile uint32_t ldoctrl;
+} mxc_mcr_regs_t;
+
+#define MXC_F_MCR_LDOCTRL_0P9EN ((uint32_t)(0x1UL << 0))
+
+extern mxc_mcr_regs_t mockMcrRegs;
+#define MXC_MCR (&mockMcrRegs)
+
+#endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_MCR_REGS_H_
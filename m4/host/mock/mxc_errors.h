@@ -0,0 +1,41 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_MXC_ERRORS_H_
+#define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_MXC_ERRORS_H_
+
+/* Same values as the MSDK */
+#define E_NO_ERROR 0
+#define E_NULL_PTR -1
+#define E_NO_DEVICE -2
+#define E_BAD_PARAM -3
+#define E_INVALID -4
+#define E_UNINITIALIZED -5
+#define E_BUSY -6
+#define E_BAD_STATE -7
+#define E_UNKNOWN -8
+#define E_COMM_ERR -9
+#define E_TIME_OUT -10
+#define E_NO_RESPONSE -11
+#define E_OVERFLOW -12
+#define E_UNDERFLOW -13
+#define E_NONE_AVAIL -14
+#define E_SHUTDOWN -15
+#define E_ABORT -16
+#define E_NOT_SUPPORTED -17
+
+#endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_MXC_ERRORS_H_
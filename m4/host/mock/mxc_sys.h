@@ -0,0 +1,40 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_MXC_SYS_H_
+#define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_MXC_SYS_H_
+
+#include "mxc_device.h"
+
+typedef enum {
+    MXC_SYS_CLOCK_IPO,
+    MXC_SYS_CLOCK_IBRO,
+} mxc_sys_system_clock_t;
+
+typedef enum {
+    MXC_SYS_PERIPH_CLOCK_USB,
+} mxc_sys_periph_clock_t;
+
+typedef enum {
+    MXC_SYS_RESET0_USB,
+} mxc_sys_reset_t;
+
+int MXC_SYS_ClockSourceEnable(mxc_sys_system_clock_t clock);
+void MXC_SYS_ClockEnable(mxc_sys_periph_clock_t clock);
+void MXC_SYS_Reset_Periph(mxc_sys_reset_t reset);
+
+#endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_MXC_SYS_H_
@@ -0,0 +1,32 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_SEMPHR_H_
+#define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_SEMPHR_H_
+
+#include "queue.h"
+
+/* A binary semaphore is a one item queue of empty items, as in FreeRTOS */
+typedef QueueHandle_t SemaphoreHandle_t;
+
+#define xSemaphoreCreateBinary() xQueueCreate(1, 0)
+#define xSemaphoreTake(xSemaphore, xBlockTime) xQueueReceive((xSemaphore), NULL, (xBlockTime))
+#define xSemaphoreGive(xSemaphore) xQueueSend((xSemaphore), NULL, 0)
+#define xSemaphoreGiveFromISR(xSemaphore, pxHigherPriorityTaskWoken) \
+    xQueueSendFromISR((xSemaphore), NULL, (pxHigherPriorityTaskWoken))
+
+#endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_SEMPHR_H_
@@ -0,0 +1,38 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_STREAM_BUFFER_H_
+#define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_STREAM_BUFFER_H_
+
+#include "FreeRTOS.h"
+
+/* The stream buffer calls the firmware used to hand audio to the USB side,
+ * copied and masked where FreeRTOS copies and masks. Single reader and
+ * writer, and the trigger level is ignored */
+typedef struct StreamBufferDef_t *StreamBufferHandle_t;
+
+StreamBufferHandle_t xStreamBufferCreate(size_t xBufferSizeBytes, size_t xTriggerLevelBytes);
+size_t xStreamBufferSend(StreamBufferHandle_t xStreamBuffer, const void *pvTxData,
+                         size_t xDataLengthBytes, TickType_t xTicksToWait);
+size_t xStreamBufferReceiveFromISR(StreamBufferHandle_t xStreamBuffer, void *pvRxData,
+                                   size_t xBufferLengthBytes,
+                                   BaseType_t *pxHigherPriorityTaskWoken);
+size_t xStreamBufferBytesAvailable(StreamBufferHandle_t xStreamBuffer);
+size_t xStreamBufferSpacesAvailable(StreamBufferHandle_t xStreamBuffer);
+BaseType_t xStreamBufferReset(StreamBufferHandle_t xStreamBuffer);
+
+#endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_STREAM_BUFFER_H_
@@ -0,0 +1,194 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_TUSB_H_
+#define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_TUSB_H_
+
+/* Host stand-in for TinyUSB: the types, macros and device API the firmware
+ * uses, and the audio class callbacks it implements. MockUsb.c plays the
+ * device stack and the host, see MockUsb.h */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define OPT_MCU_MAX32690 1900
+#define OPT_OS_FREERTOS 2
+#define OPT_MODE_DEFAULT_SPEED 0x0000
+#define OPT_MODE_FULL_SPEED 0x0200
+#define OPT_MODE_HIGH_SPEED 0x0400
+
+#define TU_ATTR_PACKED __attribute__((packed))
+#define TU_ATTR_WEAK __attribute__((weak))
+#define TU_MIN(_x, _y) (((_x) < (_y)) ? (_x) : (_y))
+#define TU_MAX(_x, _y) (((_x) > (_y)) ? (_x) : (_y))
+#define TU_U16_HIGH(_u16) ((uint8_t)(((_u16) >> 8) & 0x00ff))
+#define TU_U16_LOW(_u16) ((uint8_t)((_u16)&0x00ff))
+#define TU_VERIFY(_cond)  \
+    do {                  \
+        if (!(_cond)) {   \
+            return false; \
+        }                 \
+    } while (0)
+
+static inline uint8_t tu_u16_high(uint16_t ui16)
+{
+    return TU_U16_HIGH(ui16);
+}
+
+static inline uint8_t tu_u16_low(uint16_t ui16)
+{
+    return TU_U16_LOW(ui16);
+}
+
+#define tu_le16toh(_u16) (_u16)
+
+#include "tusb_config.h"
+
+#define TUD_OPT_HIGH_SPEED ((CFG_TUD_MAX_SPEED & OPT_MODE_HIGH_SPEED) ? 1 : 0)
+
+/* As in TinyUSB's usb_descriptors helpers: a packet of the most samples one
+ * (micro)frame can carry, plus one */
+#define TUD_AUDIO_EP_SIZE(_maxFrequency, _nBytesPerSample, _nChannels)               \
+    ((((_maxFrequency + (TUD_OPT_HIGH_SPEED ? 7999 : 999)) /                       \
+       (TUD_OPT_HIGH_SPEED ? 8000 : 1000)) +                                       \
+      1) *                                                                         \
+     _nBytesPerSample * _nChannels)
+
+typedef enum {
+    TUSB_SPEED_FULL = 0,
+    TUSB_SPEED_LOW = 1,
+    TUSB_SPEED_HIGH = 2,
+} tusb_speed_t;
+
+typedef struct TU_ATTR_PACKED {
+    uint8_t bmRequestType;
+    uint8_t bRequest;
+    uint16_t wValue;
+    uint16_t wIndex;
+    uint16_t wLength;
+} tusb_control_request_t;
+
+/* Standard requests the mock host sends */
+#define TUSB_REQ_SET_INTERFACE 0x0B
+
+//--------------------------------------------------------------------+
+// Audio class, UAC2
+//--------------------------------------------------------------------+
+typedef enum {
+    AUDIO_CS_REQ_UNDEF = 0x00,
+    AUDIO_CS_REQ_CUR = 0x01,
+    AUDIO_CS_REQ_RANGE = 0x02,
+    AUDIO_CS_REQ_MEM = 0x03,
+} audio_cs_req_t;
+
+typedef enum {
+    AUDIO_CS_CTRL_UNDEF = 0x00,
+    AUDIO_CS_CTRL_SAM_FREQ = 0x01,
+    AUDIO_CS_CTRL_CLK_VALID = 0x02,
+} audio_clock_src_control_selector_t;
+
+typedef enum {
+    AUDIO_TE_CTRL_UNDEF = 0x00,
+    AUDIO_TE_CTRL_COPY_PROTECT = 0x01,
+    AUDIO_TE_CTRL_CONNECTOR = 0x02,
+} audio_terminal_control_selector_t;
+
+typedef enum {
+    AUDIO_FU_CTRL_UNDEF = 0x00,
+    AUDIO_FU_CTRL_MUTE = 0x01,
+    AUDIO_FU_CTRL_VOLUME = 0x02,
+} audio_feature_unit_control_selector_t;
+
+typedef enum {
+    AUDIO_CHANNEL_CONFIG_NON_PREDEFINED = 0x00000000,
+    AUDIO_CHANNEL_CONFIG_FRONT_LEFT = 0x00000001,
+    AUDIO_CHANNEL_CONFIG_FRONT_RIGHT = 0x00000002,
+} audio_channel_config_t;
+
+typedef struct TU_ATTR_PACKED {
+    uint8_t bNrChannels;
+    audio_channel_config_t bmChannelConfig;
+    uint8_t iChannelNames;
+} audio_desc_channel_cluster_t;
+
+typedef struct TU_ATTR_PACKED {
+    int8_t bCur;
+} audio_control_cur_1_t;
+
+typedef struct TU_ATTR_PACKED {
+    int16_t bCur;
+} audio_control_cur_2_t;
+
+typedef struct TU_ATTR_PACKED {
+    int32_t bCur;
+} audio_control_cur_4_t;
+
+#define audio_control_range_2_n_t(numSubRanges) \
+    struct TU_ATTR_PACKED {                     \
+        uint16_t wNumSubRanges;                 \
+        struct TU_ATTR_PACKED {                 \
+            int16_t bMin;                       \
+            int16_t bMax;                       \
+            uint16_t bRes;                      \
+        } subrange[numSubRanges];               \
+    }
+
+#define audio_control_range_4_n_t(numSubRanges) \
+    struct TU_ATTR_PACKED {                     \
+        uint16_t wNumSubRanges;                 \
+        struct TU_ATTR_PACKED {                 \
+            int32_t bMin;                       \
+            int32_t bMax;                       \
+            uint32_t bRes;                      \
+        } subrange[numSubRanges];               \
+    }
+
+//--------------------------------------------------------------------+
+// Device API
+//--------------------------------------------------------------------+
+bool tud_init(uint8_t rhport);
+void tud_task(void);
+void tud_int_handler(uint8_t rhport);
+tusb_speed_t tud_speed_get(void);
+bool tud_control_xfer(uint8_t rhport, tusb_control_request_t const *request, void *buffer,
+                      uint16_t len);
+uint16_t tud_audio_write(const void *data, uint16_t len);
+bool tud_audio_buffer_and_schedule_control_xfer(uint8_t rhport,
+                                                tusb_control_request_t const *p_request,
+                                                void *data, uint16_t len);
+
+//--------------------------------------------------------------------+
+// Audio class callbacks, implemented by the application
+//--------------------------------------------------------------------+
+bool tud_audio_tx_done_pre_load_cb(uint8_t rhport, uint8_t itf, uint8_t ep_in,
+                                   uint8_t cur_alt_setting);
+bool tud_audio_tx_done_post_load_cb(uint8_t rhport, uint16_t n_bytes_copied, uint8_t itf,
+                                    uint8_t ep_in, uint8_t cur_alt_setting);
+bool tud_audio_set_itf_cb(uint8_t rhport, tusb_control_request_t const *p_request);
+bool tud_audio_set_itf_close_EP_cb(uint8_t rhport, tusb_control_request_t const *p_request);
+bool tud_audio_set_req_ep_cb(uint8_t rhport, tusb_control_request_t const *p_request,
+                             uint8_t *pBuff);
+bool tud_audio_set_req_itf_cb(uint8_t rhport, tusb_control_request_t const *p_request,
+                              uint8_t *pBuff);
+bool tud_audio_set_req_entity_cb(uint8_t rhport, tusb_control_request_t const *p_request,
+                                 uint8_t *pBuff);
+bool tud_audio_get_req_ep_cb(uint8_t rhport, tusb_control_request_t const *p_request);
+bool tud_audio_get_req_itf_cb(uint8_t rhport, tusb_control_request_t const *p_request);
+bool tud_audio_get_req_entity_cb(uint8_t rhport, tusb_control_request_t const *p_request);
+
+#endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_TUSB_H_
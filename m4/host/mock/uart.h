@@ -0,0 +1,57 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_UART_H_
+#define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_UART_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "mxc_device.h"
+
+typedef struct {
+    volatile uint32_t ctrl;
+} mxc_uart_regs_t;
+
+extern mxc_uart_regs_t mockUartRegs[4];
+#define MXC_UART_GET_UART(i) (&mockUartRegs[(i)])
+
+typedef enum {
+    MXC_UART_APB_CLK,
+    MXC_UART_IBRO_CLK = 2,
+    MXC_UART_ERFO_CLK,
+} mxc_uart_clock_t;
+
+typedef struct _mxc_uart_req_t mxc_uart_req_t;
+typedef void (*mxc_uart_complete_cb_t)(mxc_uart_req_t *req, int result);
+
+struct _mxc_uart_req_t {
+    mxc_uart_regs_t *uart;
+    const uint8_t *txData;
+    uint8_t *rxData;
+    uint32_t txLen;
+    uint32_t rxLen;
+    volatile uint32_t txCnt;
+    volatile uint32_t rxCnt;
+    mxc_uart_complete_cb_t callback;
+};
+
+int MXC_UART_SetFrequency(mxc_uart_regs_t *uart, unsigned int baud, mxc_uart_clock_t clock);
+int MXC_UART_SetAutoDMAHandlers(mxc_uart_regs_t *uart, bool enable);
+int MXC_UART_TransactionDMA(mxc_uart_req_t *req);
+
+#endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_UART_H_
@@ -0,0 +1,353 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+/**
+ * Times the I2S to USB handoff per packet, for the stream buffer the baseline
+ * used and for the capture ring that replaced it, and checks both deliver the
+ * captured stream in order.
+ *
+ * The real I2S_Task.c and Codec.c run on the mock kernel and MSDK, capturing
+ * a counting pattern, and a task here takes a packet every service interval
+ * the way the pre-load callback does:
+ *
+ * Capture ring: I2S_TaskBytesAvailable, then I2S_TaskPeek and I2S_TaskConsume
+ * straight out of the DMA buffers, as USB_Task.c does.
+ *
+ * Stream buffer: each buffer the ring hands over goes through
+ * xStreamBufferSend, as the baseline I2S task did, and each packet comes out
+ * with xStreamBufferBytesAvailable and xStreamBufferReceiveFromISR into a
+ * staging buffer. Taking the buffer from the ring stands in for the full
+ * queue and is not timed, nor is handing it back, which the baseline did
+ * through the empty queue.
+ *
+ * Both end with the copy tud_audio_write makes into the endpoint FIFO, so
+ * the totals are what the pre-load callback and I2S task spend per packet.
+ * Times are host nanoseconds (CycleCounter.h off target), useful for the ratio
+ * but not as M4 cycles. Masked is the part of that spent where the target
+ * would have interrupts masked, per the mock kernel, which masks where
+ * FreeRTOS does. Neither path copies audio with interrupts masked: FreeRTOS
+ * only masks a stream buffer's space check and wake up, and the ring's
+ * counts need no masking at all.
+ *
+ * Usage: BenchHandoff [seconds of audio per run, default 60]
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "AudioConfig.h"
+#include "Codec.h"
+#include "CycleCounter.h"
+#include "HostTest.h"
+#include "I2S_Task.h"
+#include "MockKernel.h"
+#include "MockMsdk.h"
+#include "USB_Task.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "stream_buffer.h"
+
+#define BENCH_NS_PER_SEC 1000000000ULL
+/* Codec bring-up and the first buffers, before the stream opens */
+#define BENCH_START_MS 200
+/* Buffers captured before a run starts taking packets */
+#define BENCH_PRIME_BUFFERS 2
+/* As the baseline created it */
+#define BENCH_STREAM_BYTES 0x4000
+#define BENCH_MAX_PACKET 1024
+#define BENCH_SAMPLE_MASK ((uint32_t)((1ULL << AUDIO_SAMPLE_BITS) - 1))
+
+typedef enum {
+    BENCH_RING,
+    BENCH_STREAM,
+} bench_path_t;
+
+/* Time spent and packets moved by one run */
+typedef struct {
+    uint64_t packets;
+    uint64_t ns;
+    uint64_t maskedNs;
+    uint32_t start; /**< Of the section being timed */
+    uint64_t maskedStart;
+} bench_result_t;
+
+static uint32_t seconds;
+
+static StreamBufferHandle_t stream;
+
+/* Endpoint FIFO and the pre-load callback's staging buffer */
+static uint8_t fifo[BENCH_MAX_PACKET];
+static uint8_t txBuffer[BENCH_MAX_PACKET];
+
+/* Next frame number the host expects, from the counting pattern */
+static bool locked;
+static uint32_t expected;
+
+static void BenchTask(void *param);
+static void BenchSource(uint64_t frame, int32_t *samples, uint32_t channels, void *arg);
+static void Bench(const char *name, uint32_t packetsPerSec);
+static bool BenchRun(bench_path_t path, uint32_t packetsPerSec, bench_result_t *res);
+static bool BenchPrimed(void *arg);
+static bool BenchRingPacket(uint32_t packetBytes, bench_result_t *res);
+static bool BenchStreamPacket(uint32_t packetBytes, bench_result_t *res);
+static void BenchTimeStart(bench_result_t *res);
+static void BenchTimeStop(bench_result_t *res);
+static bool CheckPacket(uint32_t len);
+static uint32_t GetFrame(const uint8_t *p);
+
+int main(int argc, char **argv)
+{
+    seconds = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 60;
+
+    stream = xStreamBufferCreate(BENCH_STREAM_BYTES, 1);
+    MockI2sSetSource(BenchSource, NULL);
+    xTaskCreate(BenchTask, "Bench", 512, NULL, tskIDLE_PRIORITY + 1, NULL);
+    CycleCounterInit();
+    vTaskStartScheduler();
+    return HOST_TEST_RESULT("BenchHandoff");
+}
+
+void BenchTask(void *param)
+{
+    CodecInit();
+    I2S_TaskInit();
+    vTaskDelay(pdMS_TO_TICKS(BENCH_START_MS));
+    I2S_TaskStartStream();
+
+    printf("Handoff of %u byte buffers at %u Hz, %u byte frames, %u s of audio per run\n",
+           (unsigned)I2S_TaskBufferBytes(), (unsigned)AUDIO_SAMPLE_RATE,
+           (unsigned)AUDIO_FRAME_BYTES, (unsigned)seconds);
+    Bench("high speed", 8000);
+    Bench("full speed", 1000);
+    MockStop();
+    vTaskDelay(portMAX_DELAY);
+}
+
+/**
+ * Codec input, the counting pattern AUDIO_TEST_PATTERN puts out on the
+ * target: each frame's number on the first channel
+ */
+void BenchSource(uint64_t frame, int32_t *samples, uint32_t channels, void *arg)
+{
+    (void)arg;
+    samples[0] = (int32_t)((uint32_t)frame & BENCH_SAMPLE_MASK);
+    if (channels > 1) {
+        samples[1] = (int32_t)(~(uint32_t)frame & BENCH_SAMPLE_MASK);
+    }
+}
+
+/**
+ * Runs both paths at one packet rate and prints ns per packet
+ * @param name - Bus speed, for the report
+ * @param packetsPerSec - Packet rate
+ */
+void Bench(const char *name, uint32_t packetsPerSec)
+{
+    bench_result_t ring;
+    bench_result_t sb;
+    double ringNs;
+    double sbNs;
+
+    if (!BenchRun(BENCH_RING, packetsPerSec, &ring) ||
+        !BenchRun(BENCH_STREAM, packetsPerSec, &sb)) {
+        HOST_CHECK(false, "%s stream was not continuous", name);
+        return;
+    }
+    ringNs = (double)ring.ns / ring.packets;
+    sbNs = (double)sb.ns / sb.packets;
+    printf("  %s, %u byte packets:\n", name,
+           (unsigned)((AUDIO_SAMPLE_RATE / packetsPerSec) * AUDIO_FRAME_BYTES));
+    printf("    stream buffer %6.1f ns per packet, %5.1f ns masked\n", sbNs,
+           (double)sb.maskedNs / sb.packets);
+    printf("    capture ring  %6.1f ns per packet, %5.1f ns masked (%.1fx faster)\n", ringNs,
+           (double)ring.maskedNs / ring.packets, sbNs / ringNs);
+}
+
+/**
+ * Takes a packet every service interval for a run's worth of audio, checking
+ * each one continues the pattern
+ * @param path - Handoff to time
+ * @param packetsPerSec - Packet rate
+ * @param res - Filled in with the packets moved and the time taken
+ * @returns true if every packet arrived whole and in order
+ */
+bool BenchRun(bench_path_t path, uint32_t packetsPerSec, bench_result_t *res)
+{
+    uint32_t packetBytes = (AUDIO_SAMPLE_RATE / packetsPerSec) * AUDIO_FRAME_BYTES;
+    uint64_t interval = BENCH_NS_PER_SEC / packetsPerSec;
+    uint64_t packets = (uint64_t)seconds * packetsPerSec;
+    uint64_t next;
+    bool sent;
+
+    memset(res, 0, sizeof(*res));
+    MockWait(BenchPrimed, NULL, MOCK_FOREVER);
+    next = MockNow();
+    while (res->packets < packets) {
+        next += interval;
+        MockWait(NULL, NULL, next);
+        if (path == BENCH_RING) {
+            sent = BenchRingPacket(packetBytes, res);
+        } else {
+            sent = BenchStreamPacket(packetBytes, res);
+        }
+        //The codec clock isn't exactly the packet rate, so the odd interval
+        //finds nothing to send. That's not a fault of either path
+        if (sent) {
+            if (!CheckPacket(packetBytes)) {
+                return false;
+            }
+            res->packets++;
+        }
+    }
+
+    //Hand whatever the stream buffer still holds over, so the next run
+    //carries on from it
+    while (xStreamBufferBytesAvailable(stream) >= packetBytes) {
+        xStreamBufferReceiveFromISR(stream, fifo, packetBytes, NULL);
+        if (!CheckPacket(packetBytes)) {
+            return false;
+        }
+    }
+    return xStreamBufferBytesAvailable(stream) == 0;
+}
+
+bool BenchPrimed(void *arg)
+{
+    (void)arg;
+    return I2S_TaskBytesAvailable() >= (BENCH_PRIME_BUFFERS * I2S_TaskBufferBytes());
+}
+
+/**
+ * One packet through the capture ring, as USB_Task.c sends it
+ * @returns true if there was a packet to send
+ */
+bool BenchRingPacket(uint32_t packetBytes, bench_result_t *res)
+{
+    const uint8_t *data;
+    uint32_t remaining;
+    uint32_t len;
+    bool sent = false;
+
+    BenchTimeStart(res);
+    if (I2S_TaskBytesAvailable() >= packetBytes) {
+        //A packet may straddle the end of one DMA buffer and the next
+        for (remaining = packetBytes; remaining > 0; remaining -= len) {
+            len = I2S_TaskPeek(&data);
+            if (len > remaining) {
+                len = remaining;
+            }
+            memcpy(&fifo[packetBytes - remaining], data, len);
+            I2S_TaskConsume(len);
+        }
+        sent = true;
+    }
+    BenchTimeStop(res);
+    return sent;
+}
+
+/**
+ * Buffers the ring has captured into the stream buffer, as the baseline I2S
+ * task sent them, then one packet out of it, as its pre-load callback did
+ * @returns true if there was a packet to send
+ */
+bool BenchStreamPacket(uint32_t packetBytes, bench_result_t *res)
+{
+    BaseType_t woken;
+    const uint8_t *data;
+    uint32_t len;
+    bool sent = false;
+
+    //Only the send is handoff work, taking the buffer stands in for the queue
+    while ((len = I2S_TaskPeek(&data)) != 0) {
+        BenchTimeStart(res);
+        xStreamBufferSend(stream, data, len, portMAX_DELAY);
+        BenchTimeStop(res);
+        I2S_TaskConsume(len);
+    }
+
+    BenchTimeStart(res);
+    if (xStreamBufferBytesAvailable(stream) >= packetBytes) {
+        xStreamBufferReceiveFromISR(stream, txBuffer, packetBytes, &woken);
+        memcpy(fifo, txBuffer, packetBytes);
+        sent = true;
+    }
+    BenchTimeStop(res);
+    return sent;
+}
+
+void BenchTimeStart(bench_result_t *res)
+{
+    res->maskedStart = MockMaskedNs();
+    res->start = CycleCounterGet();
+}
+
+void BenchTimeStop(bench_result_t *res)
+{
+    res->ns += CycleCounterGet() - res->start;
+    res->maskedNs += MockMaskedNs() - res->maskedStart;
+}
+
+/**
+ * Checks the endpoint FIFO continues the counting pattern
+ * @param len - Bytes in the FIFO
+ * @returns true if it does
+ */
+bool CheckPacket(uint32_t len)
+{
+    uint32_t frame;
+    uint32_t i;
+
+    for (i = 0; i < len; i += AUDIO_FRAME_BYTES) {
+        frame = GetFrame(&fifo[i]);
+        if (!locked) {
+            locked = true;
+        } else if (frame != expected) {
+            printf("frame 0x%x where 0x%x was expected\n", (unsigned)frame, (unsigned)expected);
+            return false;
+        }
+        expected = (frame + 1) & BENCH_SAMPLE_MASK;
+    }
+    return true;
+}
+
+/**
+ * Reads a frame's number from its first sample, little endian
+ */
+uint32_t GetFrame(const uint8_t *p)
+{
+    uint32_t v = 0;
+    uint32_t i;
+
+    for (i = 0; i < AUDIO_BYTES_PER_SAMPLE; i++) {
+        v |= (uint32_t)p[i] << (8 * i);
+    }
+    //4 byte subslots carry 24 bits MSB aligned
+    if ((AUDIO_BYTES_PER_SAMPLE == 4) && (AUDIO_SAMPLE_BITS == 24)) {
+        v >>= 8;
+    }
+    return v & BENCH_SAMPLE_MASK;
+}
+
+/* AudioStats.c reports the rate controller's estimate, but the USB side
+ * doesn't run here */
+int32_t USB_TaskDriftPpm(void)
+{
+    return 0;
+}
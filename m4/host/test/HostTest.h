@@ -0,0 +1,45 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_HOSTTEST_H_
+#define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_HOSTTEST_H_
+
+#include <stdio.h>
+
+/**
+ * Checks for the host unit tests, each a single file. A failed check prints
+ * where and why and the test carries on, HOST_TEST_RESULT() gives the exit
+ * code.
+ */
+static int hostTestFailures;
+
+#define HOST_CHECK(cond, ...)                                                \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            printf("%s:%d: check failed: %s: ", __FILE__, __LINE__, #cond); \
+            printf(__VA_ARGS__);                                             \
+            printf("\n");                                                    \
+            hostTestFailures++;                                              \
+        }                                                                    \
+    } while (0)
+
+#define HOST_TEST_RESULT(name)                                                   \
+    (printf("%s: %s (%d failed)\n", (name), hostTestFailures ? "FAIL" : "PASS", \
+            hostTestFailures),                                                   \
+     (hostTestFailures != 0))
+
+#endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_HOST_HOSTTEST_H_
@@ -0,0 +1,207 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+/**
+ * Runs Codec.c against the mock MAX9867 and checks every I2C transaction it
+ * makes: bring-up, gain changes and sample rate changes, each as the exact
+ * list of bursts (first register and length) and the register values they
+ * leave. Expected bursts follow CODEC_BRIDGE_REGS, so building with
+ * -DCODEC_BRIDGE_REGS=0 checks the unbridged flush and shows what the bridge
+ * saves. Bus time counts 9 bits a byte plus start and stop.
+ */
+
+#include <stdint.h>
+
+#include "AudioConfig.h"
+#include "Codec.h"
+#include "HostTest.h"
+#include "MockKernel.h"
+#include "MockMsdk.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define TEST_MAX_XFERS 8
+#define TEST_SETTLE_MS 50
+
+/* One expected burst */
+typedef struct {
+    uint8_t reg;
+    uint32_t len; /**< Bytes written, register address included */
+} test_xfer_t;
+
+static uint32_t totalXfers;
+static uint32_t totalBits;
+
+static void TestTask(void *param);
+static void TestStep(const char *what, uint32_t before, const test_xfer_t *expected,
+                     uint32_t count);
+static void TestRegs(const char *what, const uint8_t *regs, const uint8_t *vals, uint32_t count);
+
+int main(void)
+{
+    xTaskCreate(TestTask, "Test", 512, NULL, tskIDLE_PRIORITY + 1, NULL);
+    vTaskStartScheduler();
+
+    printf("CODEC_BRIDGE_REGS %d: %u transactions, %u bus bits\n", CODEC_BRIDGE_REGS,
+           (unsigned)totalXfers, (unsigned)totalBits);
+    return HOST_TEST_RESULT("TestCodec");
+}
+
+void TestTask(void *param)
+{
+    //Shutdown on its own, the whole map from POR as one burst, then enable
+    static const test_xfer_t init[] = { { 0x17, 2 }, { 0x04, 21 }, { 0x17, 2 } };
+    static const uint8_t initRegs[] = { 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x14, 0x17 };
+#if AUDIO_SAMPLE_BITS == 24
+    static const uint8_t initVals[] = { 0x10, 0x60, 0x00, 0x98, 0x01, 0x90, 0xA0, 0xE3 };
+#else
+    static const uint8_t initVals[] = { 0x10, 0x60, 0x00, 0x98, 0x02, 0x90, 0xA0, 0xE3 };
+#endif
+    static const uint8_t rateRegs[] = { 0x06, 0x07, 0x0A, 0x17 };
+    //Shutdown, clocking, enable
+    static const test_xfer_t rate32k[] = { { 0x17, 2 }, { 0x06, 2 }, { 0x17, 2 } };
+    static const uint8_t rate32kVals[] = { 0x40, 0x00, 0x90, 0xE3 };
+#if CODEC_BRIDGE_REGS >= 3
+    static const test_xfer_t rate96k[] = { { 0x17, 2 }, { 0x06, 6 }, { 0x17, 2 } };
+#else
+    static const test_xfer_t rate96k[] = { { 0x17, 2 }, { 0x06, 2 }, { 0x0A, 2 }, { 0x17, 2 } };
+#endif
+    static const uint8_t rate96kVals[] = { 0x60, 0x00, 0x98, 0xE3 };
+    static const test_xfer_t rate48k[] = { { 0x17, 2 }, { 0x0A, 2 }, { 0x17, 2 } };
+    static const uint8_t rate48kVals[] = { 0x60, 0x00, 0x90, 0xE3 };
+    uint32_t before;
+
+    before = MockI2cTransactions();
+    CodecInit();
+    TestStep("init", before, init, 3);
+    TestRegs("init", initRegs, initVals, sizeof(initRegs));
+
+#if AUDIO_NUM_CHANNELS == 2
+    {
+        static const uint8_t gainRegs[] = { 0x0D, 0x0E, 0x0F };
+        static const test_xfer_t both[] = { { 0x0D, 4 } };
+        //Left ADC level and right line in only, 0x0E between them is clean
+#if CODEC_BRIDGE_REGS >= 1
+        static const test_xfer_t right[] = { { 0x0D, 4 } };
+#else
+        static const test_xfer_t right[] = { { 0x0D, 2 }, { 0x0F, 2 } };
+#endif
+        static const test_xfer_t left[] = { { 0x0D, 2 } };
+        //10dB is line in 10, ADC 0. 3dB is line in 2, ADC +1. 11dB is 10 and +1
+        static const uint8_t bothVals[] = { 0x32, 0x47, 0x4B };
+        static const uint8_t rightVals[] = { 0x33, 0x47, 0x47 };
+        static const uint8_t leftVals[] = { 0x23, 0x47, 0x47 };
+
+        //Both channels queued before the codec task runs go out together
+        before = MockI2cTransactions();
+        CodecSetInputGain(0, 10);
+        CodecSetInputGain(1, 3);
+        vTaskDelay(pdMS_TO_TICKS(TEST_SETTLE_MS));
+        TestStep("gain, both channels", before, both, 1);
+        TestRegs("gain, both channels", gainRegs, bothVals, sizeof(gainRegs));
+
+        //Nothing changed, nothing sent
+        before = MockI2cTransactions();
+        CodecSetInputGain(0, 10);
+        vTaskDelay(pdMS_TO_TICKS(TEST_SETTLE_MS));
+        TestStep("gain, unchanged", before, NULL, 0);
+
+        before = MockI2cTransactions();
+        CodecSetInputGain(1, 10);
+        vTaskDelay(pdMS_TO_TICKS(TEST_SETTLE_MS));
+        TestStep("gain, right", before, right, sizeof(right) / sizeof(right[0]));
+        TestRegs("gain, right", gainRegs, rightVals, sizeof(gainRegs));
+
+        before = MockI2cTransactions();
+        CodecSetInputGain(0, 11);
+        vTaskDelay(pdMS_TO_TICKS(TEST_SETTLE_MS));
+        TestStep("gain, left", before, left, 1);
+        TestRegs("gain, left", gainRegs, leftVals, sizeof(gainRegs));
+    }
+#endif
+
+    //Rates below 48kHz only move the NI high byte, 96kHz also sets DHF
+    before = MockI2cTransactions();
+    CodecSetSampleRate(32000);
+    TestStep("rate 32kHz", before, rate32k, 3);
+    TestRegs("rate 32kHz", rateRegs, rate32kVals, sizeof(rateRegs));
+
+    before = MockI2cTransactions();
+    CodecSetSampleRate(96000);
+    TestStep("rate 96kHz", before, rate96k, sizeof(rate96k) / sizeof(rate96k[0]));
+    TestRegs("rate 96kHz", rateRegs, rate96kVals, sizeof(rateRegs));
+
+    before = MockI2cTransactions();
+    CodecSetSampleRate(48000);
+    TestStep("rate 48kHz", before, rate48k, 3);
+    TestRegs("rate 48kHz", rateRegs, rate48kVals, sizeof(rateRegs));
+
+    MockStop();
+    vTaskDelay(portMAX_DELAY);
+}
+
+/**
+ * Checks the transactions since a count against a list, and adds them to the
+ * totals
+ * @param what - Step name, for failures
+ * @param before - MockI2cTransactions() before the step
+ * @param expected - Bursts the step should make, in order
+ * @param count - Entries in expected
+ */
+void TestStep(const char *what, uint32_t before, const test_xfer_t *expected, uint32_t count)
+{
+    mock_i2c_xfer_t log[TEST_MAX_XFERS];
+    uint32_t made = MockI2cTransactions() - before;
+    uint32_t i;
+
+    HOST_CHECK(made == count, "%s: %u transactions, expected %u", what, (unsigned)made,
+               (unsigned)count);
+    if ((made != count) || (made > TEST_MAX_XFERS)) {
+        return;
+    }
+    MockI2cLog(log, made);
+    for (i = 0; i < made; i++) {
+        HOST_CHECK(log[i].addr == MOCK_CODEC_ADDR, "%s: transaction %u to 0x%02X", what,
+                   (unsigned)i, (unsigned)log[i].addr);
+        HOST_CHECK((log[i].reg == expected[i].reg) && (log[i].len == expected[i].len),
+                   "%s: transaction %u wrote %u bytes at 0x%02X, expected %u at 0x%02X", what,
+                   (unsigned)i, (unsigned)log[i].len, (unsigned)log[i].reg,
+                   (unsigned)expected[i].len, (unsigned)expected[i].reg);
+        //Device address byte, the bytes written, start and stop
+        totalBits += ((log[i].len + 1) * 9) + 2;
+    }
+    totalXfers += made;
+}
+
+/**
+ * Checks registers of the mock codec
+ * @param what - Step name, for failures
+ * @param regs - Register addresses
+ * @param vals - Values they should hold
+ * @param count - Registers to check
+ */
+void TestRegs(const char *what, const uint8_t *regs, const uint8_t *vals, uint32_t count)
+{
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        HOST_CHECK(MockCodecReg(regs[i]) == vals[i],
+                   "%s: register 0x%02X is 0x%02X, expected 0x%02X", what, (unsigned)regs[i],
+                   (unsigned)MockCodecReg(regs[i]), (unsigned)vals[i]);
+    }
+}
@@ -0,0 +1,315 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/**
+ * Checks GainApply against a scalar reference: y = (s * g) >> 15 saturated to
+ * the sample width, with g stepping linearly from the old gain to the new one
+ * over GAIN_RAMP_FRAMES frames, and every channel at unity once settled
+ * passing through untouched. Covers the steady state at every table gain,
+ * ramps up, down, into and out of mute, ramps retargeted halfway, buffers that
+ * split a ramp, and mute. Built for the DMA sample format and channel count
+ * the configuration selects.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "Gain.h"
+#include "HostTest.h"
+
+#if AUDIO_DMA_BYTES_PER_SAMPLE == 4
+typedef int32_t test_sample_t;
+#define TEST_SAMPLE_MAX 0x7FFFFF
+#define TEST_SAMPLE_MIN (-0x800000)
+#else
+typedef int16_t test_sample_t;
+#define TEST_SAMPLE_MAX 0x7FFF
+#define TEST_SAMPLE_MIN (-0x8000)
+#endif
+
+#define TEST_FRAMES (3 * GAIN_RAMP_FRAMES)
+#define TEST_SAMPLES (TEST_FRAMES * AUDIO_NUM_CHANNELS)
+
+/* Reference ramp state, one per channel */
+typedef struct {
+    int32_t current; /**< Q15 in bits 31:16 */
+    int32_t step;
+    int16_t target;
+} test_ramp_t;
+
+static uint32_t seed = 0x2545F491;
+
+static uint32_t TestRandom(void);
+static void TestFill(test_sample_t *samples, uint32_t count, bool fullScale);
+static test_sample_t RefSample(test_sample_t s, int32_t g);
+static void RefSetTarget(test_ramp_t *ramp, int16_t target);
+static int32_t RefNextGain(test_ramp_t *ramp);
+static void TestChange(gain_t *gain, test_ramp_t *ramps, const int16_t *targets,
+                       uint32_t frames, uint32_t chunk, const char *what);
+
+int main(void)
+{
+    static test_sample_t data[TEST_SAMPLES];
+    static test_sample_t copy[TEST_SAMPLES];
+    static const int16_t edges[] = { GAIN_UNITY, GAIN_MUTE, 1, 0x4000, 33 };
+    test_ramp_t ramps[AUDIO_NUM_CHANNELS];
+    int16_t targets[AUDIO_NUM_CHANNELS];
+    gain_t gain;
+    int32_t db;
+    uint32_t ch;
+    uint32_t i;
+    uint32_t e;
+
+    //Unity leaves the data alone, bit for bit
+    GainInit(&gain);
+    TestFill(data, TEST_SAMPLES, false);
+    memcpy(copy, data, sizeof(data));
+    GainApply(&gain, data, TEST_FRAMES);
+    HOST_CHECK(memcmp(copy, data, sizeof(data)) == 0, "unity changed the data");
+
+    //Full scale and random data at every gain in the table, once settled
+    for (db = 0; db >= GAIN_MIN_DB - 1; db--) {
+        GainInit(&gain);
+        for (ch = 0; ch < AUDIO_NUM_CHANNELS; ch++) {
+            GainSetTarget(&gain, ch, GainDbToQ15(db * 256));
+        }
+        GainApply(&gain, data, TEST_FRAMES);
+        TestFill(data, TEST_SAMPLES, (db & 1) != 0);
+        memcpy(copy, data, sizeof(data));
+        GainApply(&gain, data, TEST_FRAMES);
+        for (i = 0; i < TEST_SAMPLES; i++) {
+            if (data[i] != ((db == 0) ? copy[i] : RefSample(copy[i], GainDbToQ15(db * 256)))) {
+                HOST_CHECK(false, "%ddB, sample %u: %d from %d", (int)db, (unsigned)i,
+                           (int)data[i], (int)copy[i]);
+                break;
+            }
+        }
+    }
+    HOST_CHECK(GainDbToQ15(-100 * 256) == GainDbToQ15(GAIN_MIN_DB * 256), "below the table");
+    HOST_CHECK(GainDbToQ15(6 * 256) == GAIN_UNITY, "positive volume");
+
+    //Ramps between the edges of the range in both directions, through mute.
+    //Whole buffers, then buffers that end mid ramp
+    for (i = 0; i < 2; i++) {
+        GainInit(&gain);
+        for (ch = 0; ch < AUDIO_NUM_CHANNELS; ch++) {
+            ramps[ch].current = (int32_t)GAIN_UNITY << 16;
+            ramps[ch].target = GAIN_UNITY;
+            ramps[ch].step = 0;
+        }
+        for (e = 0; e < sizeof(edges) / sizeof(edges[0]); e++) {
+            for (ch = 0; ch < AUDIO_NUM_CHANNELS; ch++) {
+                //Channels ramp opposite ways
+                targets[ch] = edges[(e + ch * 2) % (sizeof(edges) / sizeof(edges[0]))];
+            }
+            TestChange(&gain, ramps, targets, TEST_FRAMES, i ? 33 : TEST_FRAMES, "ramp");
+        }
+    }
+
+    //A new target partway through a ramp restarts it from where it got to,
+    //which is between Q15 steps, so the new ramp can end on an odd frame
+    GainInit(&gain);
+    for (ch = 0; ch < AUDIO_NUM_CHANNELS; ch++) {
+        ramps[ch].current = (int32_t)GAIN_UNITY << 16;
+        ramps[ch].target = GAIN_UNITY;
+        targets[ch] = GAIN_MUTE;
+    }
+    TestChange(&gain, ramps, targets, 99, 33, "retarget");
+    for (ch = 0; ch < AUDIO_NUM_CHANNELS; ch++) {
+        targets[ch] = 0x4000;
+    }
+    TestChange(&gain, ramps, targets, TEST_FRAMES, TEST_FRAMES, "retarget");
+
+    //Muted, then back to unity: silence, then the data untouched again
+    for (ch = 0; ch < AUDIO_NUM_CHANNELS; ch++) {
+        GainSetTarget(&gain, ch, GAIN_MUTE);
+    }
+    GainApply(&gain, data, TEST_FRAMES);
+    TestFill(data, TEST_SAMPLES, true);
+    GainApply(&gain, data, TEST_FRAMES);
+    for (i = 0; (i < TEST_SAMPLES) && (data[i] == 0); i++) {}
+    HOST_CHECK(i == TEST_SAMPLES, "muted, sample %u is %d", (unsigned)i, (int)data[i]);
+    for (ch = 0; ch < AUDIO_NUM_CHANNELS; ch++) {
+        GainSetTarget(&gain, ch, GAIN_UNITY);
+    }
+    GainApply(&gain, data, TEST_FRAMES);
+    TestFill(data, TEST_SAMPLES, false);
+    memcpy(copy, data, sizeof(data));
+    GainApply(&gain, data, TEST_FRAMES);
+    HOST_CHECK(memcmp(copy, data, sizeof(data)) == 0, "unity after mute changed the data");
+
+    return HOST_TEST_RESULT("TestGain");
+}
+
+uint32_t TestRandom(void)
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+/**
+ * Fills a buffer in the DMA format, random or alternating full scale
+ */
+void TestFill(test_sample_t *samples, uint32_t count, bool fullScale)
+{
+    uint32_t i;
+    int32_t v;
+
+    for (i = 0; i < count; i++) {
+        if (fullScale) {
+            v = (i & 1) ? TEST_SAMPLE_MIN : TEST_SAMPLE_MAX;
+        } else {
+            v = (int32_t)(TestRandom() % (TEST_SAMPLE_MAX - TEST_SAMPLE_MIN + 1)) + TEST_SAMPLE_MIN;
+        }
+#if AUDIO_DMA_BYTES_PER_SAMPLE == 4
+        //24 bits MSB aligned
+        samples[i] = (test_sample_t)((uint32_t)v << 8);
+#else
+        samples[i] = (test_sample_t)v;
+#endif
+    }
+}
+
+/**
+ * The scalar definition of the gain stage
+ */
+test_sample_t RefSample(test_sample_t s, int32_t g)
+{
+#if AUDIO_DMA_BYTES_PER_SAMPLE == 4
+    int64_t y = ((int64_t)(s >> 8) * g) >> 15;
+#else
+    int64_t y = ((int64_t)s * g) >> 15;
+#endif
+
+    if (y > TEST_SAMPLE_MAX) {
+        y = TEST_SAMPLE_MAX;
+    } else if (y < TEST_SAMPLE_MIN) {
+        y = TEST_SAMPLE_MIN;
+    }
+#if AUDIO_DMA_BYTES_PER_SAMPLE == 4
+    return (test_sample_t)((uint32_t)y << 8);
+#else
+    return (test_sample_t)y;
+#endif
+}
+
+/**
+ * A ramp runs GAIN_RAMP_FRAMES frames from the gain reached so far, in equal
+ * steps of the Q15 gain held to 16 more fractional bits
+ */
+void RefSetTarget(test_ramp_t *ramp, int16_t target)
+{
+    if (target == ramp->target) {
+        return;
+    }
+    ramp->target = target;
+    ramp->step = (((int32_t)target << 16) - ramp->current) / GAIN_RAMP_FRAMES;
+    if (ramp->step == 0) {
+        ramp->step = (target > (ramp->current >> 16)) ? 1 : -1;
+    }
+}
+
+/**
+ * The gain for the next frame, landing exactly on the target
+ */
+int32_t RefNextGain(test_ramp_t *ramp)
+{
+    int32_t end = (int32_t)ramp->target << 16;
+
+    if (ramp->current != end) {
+        ramp->current += ramp->step;
+        if ((ramp->step > 0) ? (ramp->current > end) : (ramp->current < end)) {
+            ramp->current = end;
+        }
+    }
+    return ramp->current >> 16;
+}
+
+/**
+ * Sets new targets and runs random data through in chunks, checking every
+ * sample against the reference and that the ramp lands in time. While any
+ * channel ramps, every channel is scaled, unity included. Once all have
+ * landed they are scaled by their targets, unless all are at unity.
+ * @param frames - Frames to run, TEST_FRAMES at most. Short of
+ *                 GAIN_RAMP_FRAMES leaves the ramp part done
+ * @param chunk - Frames per GainApply call. Each call gets its own word
+ *                aligned buffer, like a DMA buffer, so any length works
+ */
+void TestChange(gain_t *gain, test_ramp_t *ramps, const int16_t *targets, uint32_t frames,
+                uint32_t chunk, const char *what)
+{
+    static test_sample_t data[TEST_SAMPLES];
+    static test_sample_t copy[TEST_SAMPLES];
+    static uint32_t buffer[TEST_SAMPLES];
+    test_sample_t expected;
+    int32_t g[AUDIO_NUM_CHANNELS];
+    uint32_t frame;
+    uint32_t len;
+    uint32_t ch;
+    uint32_t i;
+    bool ramping;
+    bool unity;
+    bool failed = false;
+
+    for (ch = 0; ch < AUDIO_NUM_CHANNELS; ch++) {
+        GainSetTarget(gain, ch, targets[ch]);
+        RefSetTarget(&ramps[ch], targets[ch]);
+    }
+    TestFill(data, TEST_SAMPLES, false);
+    memcpy(copy, data, sizeof(data));
+    for (frame = 0; frame < frames; frame += len) {
+        len = (frames - frame < chunk) ? (frames - frame) : chunk;
+        memcpy(buffer, &data[frame * AUDIO_NUM_CHANNELS], len * sizeof(data[0]) * AUDIO_NUM_CHANNELS);
+        GainApply(gain, buffer, len);
+        memcpy(&data[frame * AUDIO_NUM_CHANNELS], buffer, len * sizeof(data[0]) * AUDIO_NUM_CHANNELS);
+    }
+
+    for (frame = 0; (frame < frames) && !failed; frame++) {
+        ramping = false;
+        unity = true;
+        for (ch = 0; ch < AUDIO_NUM_CHANNELS; ch++) {
+            ramping = ramping || (ramps[ch].current != ((int32_t)ramps[ch].target << 16));
+            unity = unity && (ramps[ch].target == GAIN_UNITY);
+        }
+        for (ch = 0; ch < AUDIO_NUM_CHANNELS; ch++) {
+            g[ch] = RefNextGain(&ramps[ch]);
+        }
+        //A truncated step can need one frame more to land
+        if (frame == GAIN_RAMP_FRAMES) {
+            for (ch = 0; ch < AUDIO_NUM_CHANNELS; ch++) {
+                HOST_CHECK(g[ch] == targets[ch], "%s: ch %u at %d after %u frames, not %d",
+                           what, (unsigned)ch, (int)g[ch], (unsigned)frame + 1,
+                           (int)targets[ch]);
+            }
+        }
+        for (ch = 0; ch < AUDIO_NUM_CHANNELS; ch++) {
+            i = frame * AUDIO_NUM_CHANNELS + ch;
+            expected = (!ramping && unity) ? copy[i] : RefSample(copy[i], g[ch]);
+            if (data[i] != expected) {
+                HOST_CHECK(false, "%s to %d, chunks of %u, frame %u ch %u: %d from %d, gain %d",
+                           what, (int)targets[ch], (unsigned)chunk, (unsigned)frame,
+                           (unsigned)ch, (int)data[i], (int)copy[i], (int)g[ch]);
+                failed = true;
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,235 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+/**
+ * Hammers the logging ring from several host threads at once while the
+ * logging task drains it to the mock UART, as ISRs and tasks of different
+ * priorities would on the target. Each thread logs numbered lines of varying
+ * length from its own source, so the ring wraps at every offset. Checks that
+ * every line that comes out is whole and uncorrupted, that each thread's
+ * lines come out in order, and that every line is either printed or counted
+ * as dropped against its source.
+ *
+ * Usage: TestLogging [lines per thread, default 20000]
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "HostTest.h"
+#include "Logging.h"
+#include "MockKernel.h"
+#include "MockMsdk.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define TEST_THREADS LOG_SOURCE_COUNT
+#define TEST_MAX_PAD 150
+#define TEST_LINE_BYTES 256
+
+/* Per thread (and source) accounting */
+typedef struct {
+    pthread_t thread;
+    uint32_t id;
+    uint32_t sent;
+    uint32_t received;
+    uint32_t dropped;
+    int64_t lastSeq;
+} test_producer_t;
+
+static test_producer_t producers[TEST_THREADS];
+static uint32_t linesPerThread = 20000;
+static volatile uint32_t running;
+
+/* Console output, reassembled into lines */
+static char sinkLine[TEST_LINE_BYTES];
+static uint32_t sinkLen;
+static uint32_t badLines;
+
+static void TestTask(void *param);
+static void *TestProducer(void *arg);
+static uint32_t TestChecksum(uint32_t id, uint32_t seq, uint32_t pad);
+static void TestSink(const uint8_t *data, uint32_t len, void *arg);
+static void TestLine(const char *line);
+
+int main(int argc, char **argv)
+{
+    uint32_t i;
+
+    if (argc > 1) {
+        linesPerThread = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+    MockUartSetSink(TestSink, NULL);
+    LoggingInit();
+    xTaskCreate(TestTask, "Test", 512, NULL, tskIDLE_PRIORITY + 1, NULL);
+
+    //The threads wake the logging task, so the scheduler idles rather than
+    //giving up while they run
+    running = TEST_THREADS;
+    MockExternalWakers(true);
+    for (i = 0; i < TEST_THREADS; i++) {
+        producers[i].id = i;
+        producers[i].lastSeq = -1;
+        pthread_create(&producers[i].thread, NULL, TestProducer, &producers[i]);
+    }
+    vTaskStartScheduler();
+    for (i = 0; i < TEST_THREADS; i++) {
+        pthread_join(producers[i].thread, NULL);
+    }
+
+    HOST_CHECK(badLines == 0, "%u corrupt lines", (unsigned)badLines);
+    HOST_CHECK(sinkLen == 0, "output ends part way through a line");
+    for (i = 0; i < TEST_THREADS; i++) {
+        printf("Source %u: %u lines, %u printed, %u dropped\n", (unsigned)i,
+               (unsigned)producers[i].sent, (unsigned)producers[i].received,
+               (unsigned)producers[i].dropped);
+        HOST_CHECK(producers[i].received + producers[i].dropped == producers[i].sent,
+                   "source %u lost %d lines", (unsigned)i,
+                   (int)(producers[i].sent - producers[i].received - producers[i].dropped));
+        HOST_CHECK(producers[i].received > 0, "nothing printed from source %u", (unsigned)i);
+    }
+    return HOST_TEST_RESULT("TestLogging");
+}
+
+/**
+ * Waits for the threads, lets the console drain, then has the drops reported
+ * and drained in turn
+ */
+void TestTask(void *param)
+{
+    while (__atomic_load_n(&running, __ATOMIC_ACQUIRE) != 0) {
+        vTaskDelay(1);
+    }
+    MockExternalWakers(false);
+
+    //A full ring takes well under a second at 115200
+    vTaskDelay(pdMS_TO_TICKS(1000));
+    LoggingReportDrops();
+    vTaskDelay(pdMS_TO_TICKS(1000));
+    MockStop();
+    vTaskDelay(portMAX_DELAY);
+}
+
+/**
+ * Logs numbered lines with a checksum and padding that varies in length and
+ * content line to line
+ */
+void *TestProducer(void *arg)
+{
+    static const char fill[] = "abcdefghijklmnopqrstuvwxyz";
+    test_producer_t *p = arg;
+    char pad[TEST_MAX_PAD + 1];
+    uint32_t seq;
+    uint32_t n;
+    uint32_t i;
+
+    for (seq = 0; seq < linesPerThread; seq++) {
+        n = (seq * 7 + p->id * 13) % (TEST_MAX_PAD + 1);
+        for (i = 0; i < n; i++) {
+            pad[i] = fill[(seq + p->id + i) % 26];
+        }
+        pad[n] = '\0';
+        LoggingPrint((log_source_t)p->id, "P%u %u %08x %s\n", (unsigned)p->id, (unsigned)seq,
+                     (unsigned)TestChecksum(p->id, seq, n), pad);
+        p->sent++;
+        //Give the logging task a look in now and then, or nearly all drop
+        if ((seq % 16) == 0) {
+            sched_yield();
+        }
+    }
+    __atomic_fetch_sub(&running, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+uint32_t TestChecksum(uint32_t id, uint32_t seq, uint32_t pad)
+{
+    uint32_t h = 2166136261u;
+
+    h = (h ^ id) * 16777619u;
+    h = (h ^ seq) * 16777619u;
+    h = (h ^ pad) * 16777619u;
+    return h;
+}
+
+/**
+ * UART output, in whatever pieces the logging task sent it
+ */
+void TestSink(const uint8_t *data, uint32_t len, void *arg)
+{
+    uint32_t i;
+
+    for (i = 0; i < len; i++) {
+        if (data[i] == '\n') {
+            sinkLine[sinkLen] = '\0';
+            TestLine(sinkLine);
+            sinkLen = 0;
+        } else if (sinkLen < TEST_LINE_BYTES - 1) {
+            sinkLine[sinkLen++] = (char)data[i];
+        } else {
+            badLines++;
+            sinkLen = 0;
+        }
+    }
+}
+
+/**
+ * Checks one line of output and counts it
+ */
+void TestLine(const char *line)
+{
+    unsigned id;
+    unsigned seq;
+    unsigned sum;
+    unsigned count;
+    unsigned src;
+    int used = 0;
+    const char *drops = strstr(line, "Dropped ");
+    uint32_t n;
+    uint32_t i;
+    test_producer_t *p;
+
+    //The drop report goes through LOG_MSG_WARN, so has a level prefix
+    if ((drops != NULL) &&
+        (sscanf(drops, "Dropped %u log records from source %u", &count, &src) == 2)) {
+        if (src < TEST_THREADS) {
+            producers[src].dropped += count;
+            return;
+        }
+    } else if ((sscanf(line, "P%u %u %08x %n", &id, &seq, &sum, &used) == 3) && (used > 0) &&
+               (id < TEST_THREADS)) {
+        p = &producers[id];
+        n = (uint32_t)strlen(line + used);
+        for (i = 0; i < n; i++) {
+            if (line[used + i] != "abcdefghijklmnopqrstuvwxyz"[(seq + id + i) % 26]) {
+                break;
+            }
+        }
+        if ((i == n) && (sum == TestChecksum(id, seq, n)) && ((int64_t)seq > p->lastSeq)) {
+            p->lastSeq = seq;
+            p->received++;
+            return;
+        }
+    }
+    printf("Bad line: %s\n", line);
+    badLines++;
+}
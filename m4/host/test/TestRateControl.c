@@ -0,0 +1,233 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+/**
+ * Long run model of the rate controller. The codec fills DMA buffers at a
+ * clock offset from the USB clock and the controller sizes one packet per
+ * service interval, the way USB_Task.c drives it, for hours of stream at
+ * every latency profile and both speeds. Checks that nothing underflows or
+ * overruns once primed, that the fill settles on the target, and that the
+ * drift estimate settles on the real offset. Also checks the integrator
+ * clamp: a long stall must not wind the loop up past what it can unwind.
+ *
+ * usage: TestRateControl [hours]
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "HostTest.h"
+#include "RateControl.h"
+
+#define TEST_SAMPLE_RATE 48000
+
+/* Settled means within this of the real offset, and this long after the start.
+ * A Q16 step of the estimate is 2.5ppm at 6 frames per packet */
+#define TEST_DRIFT_TOLERANCE_PPM 20
+#define TEST_SETTLE_SEC 600
+
+/* Matches AUDIO_USB_MIN_FILL_PACKETS */
+#define TEST_MIN_FILL_PACKETS 3
+
+typedef struct {
+    const char *name;
+    uint32_t bufFrames; /**< Frames per DMA buffer */
+    uint32_t numBuffers; /**< Ring size, two of them held by the DMA */
+    uint32_t packetsPerSec;
+} test_config_t;
+
+typedef struct {
+    bool settled; /**< Ran past the settle time, so the rest is valid */
+    uint32_t underflows;
+    uint32_t overruns;
+    uint32_t fillMin;
+    uint32_t fillMax;
+    double driftErrMax; /**< Once settled, ppm */
+    double fillErrMax; /**< Once settled, filtered fill from target, frames */
+    int32_t driftEnd;
+} test_result_t;
+
+static const test_config_t configs[] = {
+    { "20ms HS", 960, 8, 8000 }, { "20ms FS", 960, 8, 1000 }, { "1ms HS", 48, 16, 8000 },
+    { "1ms FS", 48, 16, 1000 },  { "125us HS", 6, 32, 8000 }, { "125us FS", 6, 32, 1000 },
+};
+
+static const double ppms[] = { -500, -250, 0, 250, 500 };
+
+static uint32_t TestFillTarget(const test_config_t *cfg);
+static void TestRun(const test_config_t *cfg, double ppm, double seconds, double stallAt,
+                    double stallSec, test_result_t *res);
+static void TestCheck(const char *name, double ppm, const test_result_t *res,
+                      double fillErrLimit);
+
+int main(int argc, char **argv)
+{
+    double hours = (argc > 1) ? atof(argv[1]) : 2;
+    const test_config_t *cfg;
+    test_result_t res;
+    double stallSec;
+    uint32_t c;
+    uint32_t p;
+
+    printf("%.1f hours per run, drift error and fill error after %ds\n", hours,
+           TEST_SETTLE_SEC);
+    if (hours * 3600 < TEST_SETTLE_SEC) {
+        printf("Runs end before the settle time, so only underflows and overruns are "
+               "checked\n");
+    }
+    for (c = 0; c < sizeof(configs) / sizeof(configs[0]); c++) {
+        for (p = 0; p < sizeof(ppms) / sizeof(ppms[0]); p++) {
+            TestRun(&configs[c], ppms[p], hours * 3600, 0, 0, &res);
+            TestCheck(configs[c].name, ppms[p], &res, configs[c].bufFrames);
+        }
+    }
+
+    //The host stops polling at 60s for as long as the ring can take on top of
+    //the target and a buffer. The clamp has to keep the integrator unwound
+    //enough to settle by the usual time
+    cfg = &configs[0];
+    stallSec = (double)(((cfg->numBuffers - 2) * cfg->bufFrames) - TestFillTarget(cfg) -
+                        cfg->bufFrames) /
+               TEST_SAMPLE_RATE;
+    TestRun(cfg, 500, 2 * TEST_SETTLE_SEC, 60, stallSec, &res);
+    TestCheck("Stall", 500, &res, cfg->bufFrames);
+
+    return HOST_TEST_RESULT("TestRateControl");
+}
+
+/**
+ * Prints a run's results and checks them. Fill and drift only count once the
+ * run is past the settle time
+ * @param fillErrLimit - Largest filtered fill error allowed, frames
+ */
+void TestCheck(const char *name, double ppm, const test_result_t *res, double fillErrLimit)
+{
+    if (res->settled) {
+        printf("%-11s %+4.0fppm: fill %u-%u, drift %+d, max error %.1fppm %.1f frames, "
+               "%u underflows, %u overruns\n",
+               name, ppm, (unsigned)res->fillMin, (unsigned)res->fillMax, (int)res->driftEnd,
+               res->driftErrMax, res->fillErrMax, (unsigned)res->underflows,
+               (unsigned)res->overruns);
+        HOST_CHECK(res->driftErrMax <= TEST_DRIFT_TOLERANCE_PPM, "%s %+.0fppm", name, ppm);
+        HOST_CHECK(res->fillErrMax <= fillErrLimit, "%s %+.0fppm", name, ppm);
+    } else {
+        printf("%-11s %+4.0fppm: not settled, drift %+d, %u underflows, %u overruns\n", name,
+               ppm, (int)res->driftEnd, (unsigned)res->underflows, (unsigned)res->overruns);
+    }
+    HOST_CHECK(res->underflows == 0, "%s %+.0fppm", name, ppm);
+    HOST_CHECK(res->overruns == 0, "%s %+.0fppm", name, ppm);
+}
+
+/**
+ * The fill target USB_StartRateControl picks
+ */
+uint32_t TestFillTarget(const test_config_t *cfg)
+{
+    uint32_t packetFrames = TEST_SAMPLE_RATE / cfg->packetsPerSec;
+    uint32_t capacity = (cfg->numBuffers - 2) * cfg->bufFrames;
+    uint32_t headroom = (packetFrames + 1 > cfg->bufFrames) ? packetFrames + 1 : cfg->bufFrames;
+    uint32_t maxTarget = ((capacity - headroom) * 2) / 3;
+    uint32_t target = cfg->bufFrames;
+
+    if (target < TEST_MIN_FILL_PACKETS * packetFrames) {
+        target = TEST_MIN_FILL_PACKETS * packetFrames;
+    }
+    return (target > maxTarget) ? maxTarget : target;
+}
+
+/**
+ * Streams for a while. Each packet the codec has completed however many
+ * whole DMA buffers its clock has reached, and the controller takes a packet
+ * from what has been completed, priming first like the USB task does.
+ * @param stallAt - When the host stops polling, seconds, 0 for never
+ * @param stallSec - How long it stops for
+ */
+void TestRun(const test_config_t *cfg, double ppm, double seconds, double stallAt,
+             double stallSec, test_result_t *res)
+{
+    rate_ctrl_t rc;
+    uint64_t packets = (uint64_t)(seconds * cfg->packetsPerSec);
+    uint64_t settle = (uint64_t)TEST_SETTLE_SEC * cfg->packetsPerSec;
+    uint64_t stallStart = (uint64_t)(stallAt * cfg->packetsPerSec);
+    uint64_t stallEnd = stallStart + (uint64_t)(stallSec * cfg->packetsPerSec);
+    uint64_t consumed = 0;
+    uint64_t k;
+    uint32_t capacity = (cfg->numBuffers - 2) * cfg->bufFrames;
+    uint32_t target = TestFillTarget(cfg);
+    uint32_t fill;
+    uint32_t frames;
+    double framesPerPacket = (TEST_SAMPLE_RATE * (1 + ppm / 1e6)) / cfg->packetsPerSec;
+    double err;
+    bool primed = false;
+
+    RateControlInit(&rc, TEST_SAMPLE_RATE, cfg->packetsPerSec, target);
+    res->settled = packets > settle;
+    res->underflows = 0;
+    res->overruns = 0;
+    res->fillMin = UINT32_MAX;
+    res->fillMax = 0;
+    res->driftErrMax = 0;
+    res->fillErrMax = 0;
+
+    for (k = 0; k < packets; k++) {
+        //Whole buffers the codec has finished by this interval
+        fill = (uint32_t)((((uint64_t)(k * framesPerPacket) / cfg->bufFrames) * cfg->bufFrames) -
+                          consumed);
+        if (fill > capacity) {
+            //The DMA would overrun into the discard buffer and lose a buffer
+            res->overruns++;
+            consumed += cfg->bufFrames;
+            fill -= cfg->bufFrames;
+        }
+        if ((k >= stallStart) && (k < stallEnd)) {
+            continue;
+        }
+        if (!primed) {
+            if (fill < target + target / 2) {
+                continue;
+            }
+            primed = true;
+        }
+        frames = RateControlNextPacket(&rc, fill);
+        if (fill < frames) {
+            res->underflows++;
+            primed = false;
+            continue;
+        }
+        consumed += frames;
+
+        if (k >= settle) {
+            if (fill < res->fillMin) {
+                res->fillMin = fill;
+            }
+            if (fill > res->fillMax) {
+                res->fillMax = fill;
+            }
+            err = fabs(RateControlDriftPpm(&rc) - ppm);
+            if (err > res->driftErrMax) {
+                res->driftErrMax = err;
+            }
+            err = fabs((double)(rc.fillAvg - rc.target) / 65536);
+            if (err > res->fillErrMax) {
+                res->fillErrMax = err;
+            }
+        }
+    }
+    res->driftEnd = RateControlDriftPpm(&rc);
+}
@@ -0,0 +1,142 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/**
+ * Checks SamplePack24 and SampleUnpack24 against a byte at a time reference,
+ * for every tail length, in place and not, with full scale and random
+ * samples, and that nothing is written past the end.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "HostTest.h"
+#include "SampleFormat.h"
+
+#define TEST_MAX_COUNT 67
+#define TEST_ROUNDS 200
+#define TEST_CANARY 0xA5
+
+static uint32_t seed = 0x2545F491;
+
+static uint32_t TestRandom(void);
+static void TestFill(int32_t *samples, uint32_t count, uint32_t round);
+static void RefPack24(uint8_t *dst, const int32_t *src, uint32_t count);
+static void RefUnpack24(int32_t *dst, const uint8_t *src, uint32_t count);
+
+int main(void)
+{
+    //Word aligned, as the kernels need
+    static int32_t samples[TEST_MAX_COUNT];
+    static int32_t inPlace[TEST_MAX_COUNT + 1];
+    static int32_t unpacked[TEST_MAX_COUNT + 1];
+    static int32_t expected[TEST_MAX_COUNT];
+    static uint32_t packedWords[TEST_MAX_COUNT + 1];
+    uint8_t *packed = (uint8_t *)packedWords;
+    uint8_t ref[TEST_MAX_COUNT * 3];
+    uint32_t count;
+    uint32_t round;
+    uint32_t i;
+
+    for (round = 0; round < TEST_ROUNDS; round++) {
+        for (count = 0; count <= TEST_MAX_COUNT; count++) {
+            TestFill(samples, count, round);
+            RefPack24(ref, samples, count);
+
+            memset(packedWords, TEST_CANARY, sizeof(packedWords));
+            SamplePack24(packed, samples, count);
+            HOST_CHECK(memcmp(packed, ref, count * 3) == 0, "pack, %u samples, round %u",
+                       (unsigned)count, (unsigned)round);
+            HOST_CHECK(packed[count * 3] == TEST_CANARY, "pack wrote past %u samples",
+                       (unsigned)count);
+
+            memcpy(inPlace, samples, count * sizeof(int32_t));
+            SamplePack24(inPlace, inPlace, count);
+            HOST_CHECK(memcmp(inPlace, ref, count * 3) == 0, "in place pack, %u samples",
+                       (unsigned)count);
+
+            RefUnpack24(expected, ref, count);
+            memset(unpacked, TEST_CANARY, sizeof(unpacked));
+            SampleUnpack24(unpacked, packed, count);
+            HOST_CHECK(memcmp(unpacked, expected, count * sizeof(int32_t)) == 0,
+                       "unpack, %u samples, round %u", (unsigned)count, (unsigned)round);
+            HOST_CHECK(((uint8_t *)unpacked)[count * 4] == TEST_CANARY,
+                       "unpack wrote past %u samples", (unsigned)count);
+
+            //The round trip keeps the 24 bits and clears the padding byte
+            for (i = 0; i < count; i++) {
+                HOST_CHECK(unpacked[i] == (int32_t)((uint32_t)samples[i] & 0xFFFFFF00UL),
+                           "round trip, sample %u of %u: 0x%08x from 0x%08x", (unsigned)i,
+                           (unsigned)count, (unsigned)unpacked[i], (unsigned)samples[i]);
+            }
+        }
+    }
+
+    return HOST_TEST_RESULT("TestSampleFormat");
+}
+
+uint32_t TestRandom(void)
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+/**
+ * The first rounds are full scale, zero and single bit patterns, which catch
+ * shifts that lose or smear a byte. The rest are random, low byte included
+ * since it is padding the pack has to drop.
+ */
+void TestFill(int32_t *samples, uint32_t count, uint32_t round)
+{
+    static const uint32_t edges[] = { 0x7FFFFF00, 0x80000000, 0xFFFFFF00, 0x00000100,
+                                      0x00000000, 0xFFFFFFFF, 0x00FF00FF, 0xFF00FF00 };
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        if (round < 8) {
+            samples[i] = (int32_t)edges[(i + round) % 8];
+        } else if (round < 8 + 24) {
+            samples[i] = (int32_t)(0x100UL << ((i + round) % 24));
+        } else {
+            samples[i] = (int32_t)TestRandom();
+        }
+    }
+}
+
+void RefPack24(uint8_t *dst, const int32_t *src, uint32_t count)
+{
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        dst[i * 3] = (uint8_t)((uint32_t)src[i] >> 8);
+        dst[i * 3 + 1] = (uint8_t)((uint32_t)src[i] >> 16);
+        dst[i * 3 + 2] = (uint8_t)((uint32_t)src[i] >> 24);
+    }
+}
+
+void RefUnpack24(int32_t *dst, const uint8_t *src, uint32_t count)
+{
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        dst[i] = (int32_t)(((uint32_t)src[i * 3] << 8) | ((uint32_t)src[i * 3 + 1] << 16) |
+                           ((uint32_t)src[i * 3 + 2] << 24));
+    }
+}
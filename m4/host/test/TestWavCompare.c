@@ -0,0 +1,162 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+/**
+ * Checks WavCompare on streams built from a reference with known damage: a
+ * late start after leading silence, dropped and duplicated runs, zero fill as
+ * an underflow would leave it, a flipped bit and a tail past the reference.
+ * Each must be counted exactly, and nothing else.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "HostTest.h"
+#include "WavCompare.h"
+
+#define TEST_CHANNELS 2
+#define TEST_REF_FRAMES 4000
+#define TEST_MAX_FRAMES 6000
+#define TEST_WINDOW 1000
+
+static int32_t ref[TEST_REF_FRAMES * TEST_CHANNELS];
+static int32_t rx[TEST_MAX_FRAMES * TEST_CHANNELS];
+static uint32_t rxFrames;
+
+static void TestRef(void);
+static void TestSilence(uint32_t frames);
+static void TestCopy(uint32_t from, uint32_t frames);
+static void TestExpect(const char *what, const wav_compare_t *expected);
+
+int main(void)
+{
+    wav_compare_t expected;
+
+    TestRef();
+
+    //Leading silence, and the receiver starts part way in
+    rxFrames = 0;
+    TestSilence(100);
+    TestCopy(37, 3000);
+    memset(&expected, 0, sizeof(expected));
+    expected.frames = 3100;
+    expected.leading = 100;
+    expected.skipped = 37;
+    expected.matched = 3000;
+    expected.aligned = true;
+    TestExpect("clean", &expected);
+
+    //5 frames lost, later 7 sent twice
+    rxFrames = 0;
+    TestCopy(0, 500);
+    TestCopy(505, 1000);
+    TestCopy(1498, 1000);
+    memset(&expected, 0, sizeof(expected));
+    expected.frames = 2500;
+    expected.matched = 2500;
+    expected.dropped = 5;
+    expected.duplicated = 7;
+    expected.aligned = true;
+    TestExpect("dropped and duplicated", &expected);
+
+    //An underflow: a packet of silence, then the audio carries on where it was
+    rxFrames = 0;
+    TestCopy(0, 800);
+    TestSilence(48);
+    TestCopy(800, 800);
+    memset(&expected, 0, sizeof(expected));
+    expected.frames = 1648;
+    expected.matched = 1600;
+    expected.zero = 48;
+    expected.aligned = true;
+    TestExpect("zero fill", &expected);
+
+    //One flipped bit, and more received than the reference holds
+    rxFrames = 0;
+    TestCopy(3000, 1000);
+    rx[(500 * TEST_CHANNELS) + 1] ^= 0x100;
+    TestSilence(20);
+    memset(&expected, 0, sizeof(expected));
+    expected.frames = 1020;
+    expected.skipped = 3000;
+    expected.matched = 999;
+    expected.corrupt = 1;
+    expected.trailing = 20;
+    expected.aligned = true;
+    TestExpect("corrupt and trailing", &expected);
+
+    //A drop longer than the window can't be lined up again
+    rxFrames = 0;
+    TestCopy(0, 100);
+    TestCopy(100 + TEST_WINDOW + 1, 10);
+    memset(&expected, 0, sizeof(expected));
+    expected.frames = 110;
+    expected.matched = 100;
+    expected.corrupt = 10;
+    expected.aligned = true;
+    TestExpect("beyond the window", &expected);
+
+    return HOST_TEST_RESULT("TestWavCompare");
+}
+
+/**
+ * A reference no run of which repeats, as audio with any noise in it
+ */
+void TestRef()
+{
+    uint32_t x = 0x2545F491;
+    uint32_t i;
+
+    for (i = 0; i < TEST_REF_FRAMES * TEST_CHANNELS; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        ref[i] = (int32_t)(x << 16) >> 16;
+        if (ref[i] == 0) {
+            ref[i] = 1;
+        }
+    }
+}
+
+void TestSilence(uint32_t frames)
+{
+    memset(&rx[rxFrames * TEST_CHANNELS], 0, frames * TEST_CHANNELS * sizeof(int32_t));
+    rxFrames += frames;
+}
+
+void TestCopy(uint32_t from, uint32_t frames)
+{
+    memcpy(&rx[rxFrames * TEST_CHANNELS], &ref[from * TEST_CHANNELS],
+           frames * TEST_CHANNELS * sizeof(int32_t));
+    rxFrames += frames;
+}
+
+void TestExpect(const char *what, const wav_compare_t *expected)
+{
+    wav_compare_t got;
+
+    WavCompare(ref, TEST_REF_FRAMES, rx, rxFrames, TEST_CHANNELS, TEST_WINDOW, 0, &got);
+    HOST_CHECK(memcmp(&got, expected, sizeof(got)) == 0,
+               "%s: %llu frames, %llu leading, %llu skipped, %llu matched, %llu dropped, "
+               "%llu duplicated, %llu zero, %llu corrupt, %llu trailing",
+               what, (unsigned long long)got.frames, (unsigned long long)got.leading,
+               (unsigned long long)got.skipped, (unsigned long long)got.matched,
+               (unsigned long long)got.dropped, (unsigned long long)got.duplicated,
+               (unsigned long long)got.zero, (unsigned long long)got.corrupt,
+               (unsigned long long)got.trailing);
+    HOST_CHECK(WavCompareClean(&got) == WavCompareClean(expected), "%s: verdict", what);
+}
@@ -0,0 +1,136 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_AUDIOCONFIG_H_
+#define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_AUDIOCONFIG_H_
+
+/* Audio stream format shared by the I2S capture path and the UAC2 function.
+ * tusb_config.h derives the TinyUSB audio settings from these, so this is the
+ * one place to change the format. Override on the command line if needed.
+ */
+
+/* Number of interleaved channels captured and streamed. 1 captures the left
+ * channel only, 2 is stereo */
+#ifndef AUDIO_NUM_CHANNELS
+#define AUDIO_NUM_CHANNELS 2
+#endif
+
+/* Resolution captured from the codec. 16, or 24 for the full ADC resolution.
+ * 24 bit samples are captured MSB aligned in 32 bit DMA words */
+#ifndef AUDIO_SAMPLE_BITS
+#define AUDIO_SAMPLE_BITS 16
+#endif
+
+/* Bytes per sample on the wire (UAC2 subslot size). 2 for 16 bit. 3 (packed)
+ * or 4 for 24 bit */
+#ifndef AUDIO_BYTES_PER_SAMPLE
+#if AUDIO_SAMPLE_BITS == 16
+#define AUDIO_BYTES_PER_SAMPLE 2
+#else
+#define AUDIO_BYTES_PER_SAMPLE 4
+#endif
+#endif
+
+/* Bytes per sample in the DMA buffers */
+#if AUDIO_SAMPLE_BITS == 16
+#define AUDIO_DMA_BYTES_PER_SAMPLE 2
+#else
+#define AUDIO_DMA_BYTES_PER_SAMPLE 4
+#endif
+
+/* Bytes per frame, one sample of every channel */
+#define AUDIO_FRAME_BYTES (AUDIO_NUM_CHANNELS * AUDIO_BYTES_PER_SAMPLE)
+
+/* Sample rate in Hz at power up. The host can switch to any rate in
+ * AUDIO_SAMPLE_RATES through the UAC2 clock source */
+#ifndef AUDIO_SAMPLE_RATE
+#define AUDIO_SAMPLE_RATE 48000
+#endif
+
+/* Rates the codec can be switched between, ascending. All are whole kHz so
+ * every buffer and packet holds a whole number of frames */
+#define AUDIO_SAMPLE_RATES { 8000, 16000, 24000, 32000, 48000, 96000 }
+#define AUDIO_NUM_SAMPLE_RATES 6
+#define AUDIO_MAX_SAMPLE_RATE 96000
+
+/* Latency profiles, trading buffering for interrupt rate. Capture buffers
+ * hold a fixed duration at every sample rate:
+ *   0 - 20ms DMA buffers, 8 of them. Tens of ms of latency, 50 IRQs/s
+ *   1 - One USB frame (1ms) per DMA buffer, 16 of them. 1000 IRQs/s
+ *   2 - One microframe (125us) per DMA buffer, 32 of them. 8000 IRQs/s,
+ *       high speed only
+ * The USB side's fill target follows the buffer size, and the TinyUSB IN FIFO
+ * shrinks to two packets for the low latency profiles */
+#ifndef AUDIO_LATENCY_PROFILE
+#define AUDIO_LATENCY_PROFILE 0
+#endif
+
+#if AUDIO_LATENCY_PROFILE == 2
+#define AUDIO_BUFF_US 125
+#define AUDIO_NUM_BUFFERS 32
+#elif AUDIO_LATENCY_PROFILE == 1
+#define AUDIO_BUFF_US 1000
+#define AUDIO_NUM_BUFFERS 16
+#elif AUDIO_LATENCY_PROFILE == 0
+#define AUDIO_BUFF_US 20000
+#define AUDIO_NUM_BUFFERS 8
+#else
+#error "AUDIO_LATENCY_PROFILE must be 0, 1 or 2"
+#endif
+
+/* High speed service interval, in 125us microframes: 1, 2, 4 or 8. Each packet
+ * carries that many microframes of audio in whole frames. Longer intervals mean
+ * fewer, larger packets for a little more latency. Full speed always sends one
+ * packet per 1ms frame. AUDIO_USB_BINTERVAL is the descriptor encoding,
+ * 2^(bInterval-1) microframes */
+#ifndef AUDIO_USB_INTERVAL_UFRAMES
+#define AUDIO_USB_INTERVAL_UFRAMES 1
+#endif
+
+#if AUDIO_USB_INTERVAL_UFRAMES == 1
+#define AUDIO_USB_BINTERVAL 1
+#elif AUDIO_USB_INTERVAL_UFRAMES == 2
+#define AUDIO_USB_BINTERVAL 2
+#elif AUDIO_USB_INTERVAL_UFRAMES == 4
+#define AUDIO_USB_BINTERVAL 3
+#elif AUDIO_USB_INTERVAL_UFRAMES == 8
+#define AUDIO_USB_BINTERVAL 4
+#else
+#error "AUDIO_USB_INTERVAL_UFRAMES must be 1, 2, 4 or 8"
+#endif
+
+/* Smallest USB fill target, in packets. Only matters when DMA buffers are
+ * shorter than this, in the low latency profiles. Raise it from the build to
+ * ride out task stalls on those profiles (see the README). The USB side primes
+ * to 1.5x the target, so I2S_Task.c checks that fits in the ring */
+#ifndef AUDIO_USB_MIN_FILL_PACKETS
+#define AUDIO_USB_MIN_FILL_PACKETS 3
+#endif
+
+#if (AUDIO_NUM_CHANNELS != 1) && (AUDIO_NUM_CHANNELS != 2)
+#error "AUDIO_NUM_CHANNELS must be 1 or 2"
+#endif
+
+#if (AUDIO_SAMPLE_BITS == 16) && (AUDIO_BYTES_PER_SAMPLE != 2)
+#error "16 bit samples use 2 byte subslots"
+#elif (AUDIO_SAMPLE_BITS == 24) && (AUDIO_BYTES_PER_SAMPLE != 3) && (AUDIO_BYTES_PER_SAMPLE != 4)
+#error "24 bit samples use 3 or 4 byte subslots"
+#elif (AUDIO_SAMPLE_BITS != 16) && (AUDIO_SAMPLE_BITS != 24)
+#error "AUDIO_SAMPLE_BITS must be 16 or 24"
+#endif
+
+#endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_AUDIOCONFIG_H_
@@ -0,0 +1,265 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "AudioStats.h"
+#include "Logging.h"
+#include "USB_Task.h"
+#include "FaultInject.h"
+
+audio_stats_block_t audioStatsTotal = { .fillMin = UINT32_MAX };
+
+/* Totals when the session started, and the session's own fill extremes. The
+ * session fields are only written by the USB task */
+static audio_stats_block_t sessionBase;
+static uint32_t sessionFillMin = UINT32_MAX;
+static uint32_t sessionFillMax;
+static uint32_t sessionCount;
+static TickType_t sessionStart;
+
+#if AUDIO_MEASURE_LATENCY
+static audio_latency_t latency = { .minUs = UINT32_MAX };
+
+static uint32_t AudioStatsLatencyPercentile(uint32_t permille);
+#endif
+static uint32_t AudioStatsPerSec(uint32_t delta, uint32_t periodMs);
+#if AUDIO_FAULT_INJECT
+static void AudioStatsSoakVerdict(const audio_stats_snapshot_t *snap);
+#endif
+
+void AudioStatsFill(uint32_t fillFrames, uint32_t targetFrames)
+{
+    uint32_t bin = 0;
+
+    if (targetFrames != 0) {
+        bin = (fillFrames * AUDIO_STATS_BINS_PER_TARGET) / targetFrames;
+    }
+    if (bin >= AUDIO_STATS_FILL_BINS) {
+        bin = AUDIO_STATS_FILL_BINS - 1;
+    }
+    audioStatsTotal.fillHist[bin]++;
+
+    if (fillFrames < audioStatsTotal.fillMin) {
+        audioStatsTotal.fillMin = fillFrames;
+    }
+    if (fillFrames > audioStatsTotal.fillMax) {
+        audioStatsTotal.fillMax = fillFrames;
+    }
+    if (fillFrames < sessionFillMin) {
+        sessionFillMin = fillFrames;
+    }
+    if (fillFrames > sessionFillMax) {
+        sessionFillMax = fillFrames;
+    }
+}
+
+#if AUDIO_MEASURE_LATENCY
+void AudioStatsLatency(uint32_t ageUs)
+{
+    uint32_t bin = ageUs / AUDIO_STATS_LAT_BIN_US;
+
+    if (bin >= AUDIO_STATS_LAT_BINS) {
+        bin = AUDIO_STATS_LAT_BINS - 1;
+    }
+    latency.hist[bin]++;
+    latency.count++;
+    latency.sumUs += ageUs;
+    if (ageUs < latency.minUs) {
+        latency.minUs = ageUs;
+    }
+    if (ageUs > latency.maxUs) {
+        latency.maxUs = ageUs;
+    }
+}
+
+/**
+ * Gets a latency percentile from the histogram
+ * @param permille - Percentile, in tenths of a percent
+ * @returns Upper edge of the bin the percentile falls in, microseconds
+ */
+uint32_t AudioStatsLatencyPercentile(uint32_t permille)
+{
+    uint32_t rank = (uint32_t)(((uint64_t)latency.count * permille + 999) / 1000);
+    uint32_t seen = 0;
+    uint32_t i;
+
+    for (i = 0; i < AUDIO_STATS_LAT_BINS - 1; i++) {
+        seen += latency.hist[i];
+        if (seen >= rank) {
+            break;
+        }
+    }
+    return (i + 1) * AUDIO_STATS_LAT_BIN_US;
+}
+#endif
+
+void AudioStatsStartSession()
+{
+    int i;
+
+    for (i = 0; i < AUDIO_STAT_COUNT; i++) {
+        sessionBase.counts[i] = __atomic_load_n(&audioStatsTotal.counts[i], __ATOMIC_RELAXED);
+    }
+    memcpy(sessionBase.fillHist, audioStatsTotal.fillHist, sizeof(sessionBase.fillHist));
+    sessionFillMin = UINT32_MAX;
+    sessionFillMax = 0;
+    sessionCount++;
+    sessionStart = xTaskGetTickCount();
+#if AUDIO_MEASURE_LATENCY
+    memset(&latency, 0, sizeof(latency));
+    latency.minUs = UINT32_MAX;
+#endif
+}
+
+void AudioStatsSnapshot(audio_stats_snapshot_t *snap)
+{
+    int i;
+
+    for (i = 0; i < AUDIO_STAT_COUNT; i++) {
+        snap->total.counts[i] = __atomic_load_n(&audioStatsTotal.counts[i], __ATOMIC_RELAXED);
+        snap->session.counts[i] = snap->total.counts[i] - sessionBase.counts[i];
+    }
+    for (i = 0; i < AUDIO_STATS_FILL_BINS; i++) {
+        snap->total.fillHist[i] = audioStatsTotal.fillHist[i];
+        snap->session.fillHist[i] = snap->total.fillHist[i] - sessionBase.fillHist[i];
+    }
+    snap->total.fillMin = audioStatsTotal.fillMin;
+    snap->total.fillMax = audioStatsTotal.fillMax;
+    snap->session.fillMin = sessionFillMin;
+    snap->session.fillMax = sessionFillMax;
+    snap->sessions = sessionCount;
+    snap->sessionMs = (sessionCount == 0) ? 0 :
+                                            (uint32_t)((xTaskGetTickCount() - sessionStart) *
+                                                       portTICK_PERIOD_MS);
+}
+
+#if AUDIO_FAULT_INJECT
+/**
+ * Logs the soak verdict for the session. Injected faults are expected to
+ * cost audio; a real overrun or underflow, or latency past
+ * AUDIO_SOAK_MAX_LATENCY_US is a failure
+ * @param snap - Snapshot being reported
+ */
+void AudioStatsSoakVerdict(const audio_stats_snapshot_t *snap)
+{
+    const uint32_t *c = snap->session.counts;
+    uint32_t overruns = c[AUDIO_STAT_DMA_OVERRUN] - c[AUDIO_STAT_FAULT_OVERRUN];
+    uint32_t maxLatency = 0;
+
+#if AUDIO_MEASURE_LATENCY
+    maxLatency = latency.maxUs;
+#endif
+    LOG_MSG_INFO(BKGND, "Injected: stall %u, DMA delay %u, overrun %u, USB skip %u",
+                 (unsigned)c[AUDIO_STAT_FAULT_STALL], (unsigned)c[AUDIO_STAT_FAULT_DELAY],
+                 (unsigned)c[AUDIO_STAT_FAULT_OVERRUN], (unsigned)c[AUDIO_STAT_FAULT_USB_SKIP]);
+    if ((overruns != 0) || (c[AUDIO_STAT_USB_UNDERFLOW] != 0) ||
+        (maxLatency > AUDIO_SOAK_MAX_LATENCY_US)) {
+        LOG_MSG_ERR(BKGND, "Soak FAIL: overrun %u, underflow %u, latency %u us",
+                    (unsigned)overruns, (unsigned)c[AUDIO_STAT_USB_UNDERFLOW],
+                    (unsigned)maxLatency);
+    } else {
+        LOG_MSG_INFO(BKGND, "Soak PASS, fill %u..%u frames, latency %u us",
+                     (unsigned)((snap->session.fillMin == UINT32_MAX) ? 0 :
+                                                                         snap->session.fillMin),
+                     (unsigned)snap->session.fillMax, (unsigned)maxLatency);
+    }
+}
+#endif
+
+/**
+ * Scales a count over a period to a rate
+ * @param delta - Count over the period
+ * @param periodMs - Length of the period
+ * @returns Count per second, 0 for an empty period
+ */
+uint32_t AudioStatsPerSec(uint32_t delta, uint32_t periodMs)
+{
+    return (periodMs == 0) ? 0 : (uint32_t)(((uint64_t)delta * 1000) / periodMs);
+}
+
+/**
+ * Logged from the background task, so it never runs in the middle of the USB
+ * task's updates
+ */
+void AudioStatsReport()
+{
+    static uint32_t lastPackets;
+    static uint32_t lastBytes;
+    static TickType_t lastTick;
+    audio_stats_snapshot_t snap;
+    const audio_stats_block_t *s = &snap.session;
+    TickType_t now = xTaskGetTickCount();
+    uint32_t periodMs = (uint32_t)((now - lastTick) * portTICK_PERIOD_MS);
+    uint32_t bytesPerSec;
+    uint32_t packetsPerSec;
+    int i;
+
+    //Quiet while nothing is streaming
+    AudioStatsSnapshot(&snap);
+    if (snap.total.counts[AUDIO_STAT_USB_PACKETS] == lastPackets) {
+        lastTick = now;
+        lastBytes = snap.total.counts[AUDIO_STAT_USB_BYTES];
+        return;
+    }
+    //Throughput over the report period. Differences, so the counters may wrap
+    bytesPerSec = AudioStatsPerSec(snap.total.counts[AUDIO_STAT_USB_BYTES] - lastBytes, periodMs);
+    packetsPerSec =
+        AudioStatsPerSec(snap.total.counts[AUDIO_STAT_USB_PACKETS] - lastPackets, periodMs);
+    lastPackets = snap.total.counts[AUDIO_STAT_USB_PACKETS];
+    lastBytes = snap.total.counts[AUDIO_STAT_USB_BYTES];
+    lastTick = now;
+    LOG_MSG_INFO(I2S, "Session %u, %u ms: DMA %u, overrun %u, gaps %u",
+                 (unsigned)snap.sessions, (unsigned)snap.sessionMs,
+                 (unsigned)s->counts[AUDIO_STAT_DMA_DONE],
+                 (unsigned)s->counts[AUDIO_STAT_DMA_OVERRUN],
+                 (unsigned)s->counts[AUDIO_STAT_SEQ_GAP]);
+    LOG_MSG_INFO(USBD, "Session packets %u, prime %u, underflow %u, fill %u..%u frames",
+                 (unsigned)s->counts[AUDIO_STAT_USB_PACKETS],
+                 (unsigned)s->counts[AUDIO_STAT_USB_PRIME],
+                 (unsigned)s->counts[AUDIO_STAT_USB_UNDERFLOW],
+                 (unsigned)((s->fillMin == UINT32_MAX) ? 0 : s->fillMin), (unsigned)s->fillMax);
+    LOG_MSG_INFO(USBD, "Throughput %u.%03u MB/s, %u packets/s, drift %d ppm",
+                 (unsigned)(bytesPerSec / 1000000), (unsigned)((bytesPerSec / 1000) % 1000),
+                 (unsigned)packetsPerSec, (int)USB_TaskDriftPpm());
+    //Histogram in quarters of the fill target, four bins per line
+    for (i = 0; i < AUDIO_STATS_FILL_BINS; i += 4) {
+        LOG_MSG_INFO(USBD, "Fill %2u/4: %u %u %u %u", (unsigned)i, (unsigned)s->fillHist[i],
+                     (unsigned)s->fillHist[i + 1], (unsigned)s->fillHist[i + 2],
+                     (unsigned)s->fillHist[i + 3]);
+    }
+#if AUDIO_MEASURE_LATENCY
+    if (latency.count != 0) {
+        LOG_MSG_INFO(USBD, "Latency us: min %u avg %u max %u",
+                     (unsigned)latency.minUs, (unsigned)(latency.sumUs / latency.count),
+                     (unsigned)latency.maxUs);
+        LOG_MSG_INFO(USBD, "Latency us: p50 %u p90 %u p99 %u p99.9 %u",
+                     (unsigned)AudioStatsLatencyPercentile(500),
+                     (unsigned)AudioStatsLatencyPercentile(900),
+                     (unsigned)AudioStatsLatencyPercentile(990),
+                     (unsigned)AudioStatsLatencyPercentile(999));
+    }
+#endif
+#if AUDIO_FAULT_INJECT
+    AudioStatsSoakVerdict(&snap);
+#endif
+    LOG_MSG_INFO(I2S, "Total: overrun %u, gaps %u, underflow %u",
+                 (unsigned)snap.total.counts[AUDIO_STAT_DMA_OVERRUN],
+                 (unsigned)snap.total.counts[AUDIO_STAT_SEQ_GAP],
+                 (unsigned)snap.total.counts[AUDIO_STAT_USB_UNDERFLOW]);
+}
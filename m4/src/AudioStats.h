@@ -0,0 +1,150 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_AUDIOSTATS_H_
+#define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_AUDIOSTATS_H_
+
+#include <stdint.h>
+#include "AudioConfig.h"
+
+/**
+ * Audio pipeline telemetry. Counters are bumped from the DMA ISR and the USB
+ * task with a single atomic add each, and the buffered fill level is sampled
+ * once per USB packet, so the whole thing is cheap enough to leave on.
+ *
+ * Totals only ever count up. A stream session (I2S_TaskStartStream) records
+ * a copy of the totals, and session values are the difference, so nothing
+ * the ISR writes is ever reset underneath it.
+ */
+
+/** Capture latency measurement. Each DMA buffer is stamped with the cycle
+ * counter when it completes, and each USB packet records how long ago its
+ * oldest sample was captured as it is queued with tud_audio_write */
+#ifndef AUDIO_MEASURE_LATENCY
+#define AUDIO_MEASURE_LATENCY 0
+#endif
+
+/** Latency histogram, for the percentiles. The last bin also holds anything
+ * above. Finer for the low latency profiles */
+#if AUDIO_LATENCY_PROFILE == 0
+#define AUDIO_STATS_LAT_BIN_US 500
+#else
+#define AUDIO_STATS_LAT_BIN_US 50
+#endif
+#define AUDIO_STATS_LAT_BINS 256
+
+/** Number of fill level histogram bins. Each bin is a quarter of the fill target,
+ * the last also holds anything above */
+#define AUDIO_STATS_FILL_BINS 16
+#define AUDIO_STATS_BINS_PER_TARGET 4
+
+typedef enum {
+    AUDIO_STAT_DMA_DONE, /**< DMA buffers completed                     */
+    AUDIO_STAT_DMA_OVERRUN, /**< Ring full, DMA filled the discard buffer  */
+    AUDIO_STAT_SEQ_GAP, /**< Jumps in buffer sequence seen by the task */
+    AUDIO_STAT_USB_PACKETS, /**< USB packets carrying audio               */
+    AUDIO_STAT_USB_BYTES, /**< Audio bytes sent, wraps                  */
+    AUDIO_STAT_USB_PRIME, /**< Zero filled packets while priming        */
+    AUDIO_STAT_USB_UNDERFLOW, /**< Zero filled packets from an underflow    */
+    AUDIO_STAT_FAULT_STALL, /**< Injected I2S task stalls                 */
+    AUDIO_STAT_FAULT_DELAY, /**< Injected DMA reload delays               */
+    AUDIO_STAT_FAULT_OVERRUN, /**< Injected DMA overruns                    */
+    AUDIO_STAT_FAULT_USB_SKIP, /**< Injected silent USB packets              */
+    AUDIO_STAT_COUNT
+} audio_stat_t;
+
+/** One set of statistics, either since boot or for a session */
+typedef struct {
+    uint32_t counts[AUDIO_STAT_COUNT];
+    uint32_t fillMin; /**< Lowest fill level seen, frames  */
+    uint32_t fillMax; /**< Highest fill level seen, frames */
+    uint32_t fillHist[AUDIO_STATS_FILL_BINS]; /**< Fill samples per bin */
+} audio_stats_block_t;
+
+/** Copy of the statistics for the reader */
+typedef struct {
+    audio_stats_block_t total; /**< Since boot                     */
+    audio_stats_block_t session; /**< Since the current stream began */
+    uint32_t sessions; /**< Stream sessions started        */
+    uint32_t sessionMs; /**< Age of the current session     */
+} audio_stats_snapshot_t;
+
+/** Capture latency, per session */
+typedef struct {
+    uint32_t count; /**< Packets measured      */
+    uint32_t minUs; /**< Youngest oldest sample */
+    uint32_t maxUs; /**< Oldest oldest sample   */
+    uint64_t sumUs; /**< For the average        */
+    uint32_t hist[AUDIO_STATS_LAT_BINS];
+} audio_latency_t;
+
+/* Live totals, only for the inline counter below */
+extern audio_stats_block_t audioStatsTotal;
+
+/**
+ * Counts one event. Safe from any context
+ * @param stat - Event to count
+ */
+static inline void AudioStatsCount(audio_stat_t stat)
+{
+    __atomic_fetch_add(&audioStatsTotal.counts[stat], 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * Adds to a counter. Safe from any context
+ * @param stat - Counter to add to
+ * @param n - Amount to add
+ */
+static inline void AudioStatsAdd(audio_stat_t stat, uint32_t n)
+{
+    __atomic_fetch_add(&audioStatsTotal.counts[stat], n, __ATOMIC_RELAXED);
+}
+
+/**
+ * Records the buffered fill level. USB task only
+ * @param fillFrames - Frames buffered
+ * @param targetFrames - The USB side's fill target, sets the histogram scale
+ */
+void AudioStatsFill(uint32_t fillFrames, uint32_t targetFrames);
+
+#if AUDIO_MEASURE_LATENCY
+/**
+ * Records one packet's capture latency. USB task only
+ * @param ageUs - Age of the packet's oldest sample when queued, microseconds
+ */
+void AudioStatsLatency(uint32_t ageUs);
+#endif
+
+/**
+ * Starts a new stream session. Same task as AudioStatsFill
+ */
+void AudioStatsStartSession(void);
+
+/**
+ * Copies out the current statistics. Counters are read one at a time, so a
+ * snapshot taken while the ISR is counting may be off by an event or so
+ * between counters, but never torn within one
+ * @param snap - Where to put the copy
+ */
+void AudioStatsSnapshot(audio_stats_snapshot_t *snap);
+
+/**
+ * Logs a summary of the session and totals
+ */
+void AudioStatsReport(void);
+
+#endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_AUDIOSTATS_H_
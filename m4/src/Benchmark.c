@@ -0,0 +1,212 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#include <string.h>
+#include "Benchmark.h"
+#include "AudioConfig.h"
+#include "Gain.h"
+#include "SampleFormat.h"
+#include "Logging.h"
+
+#if AUDIO_BENCHMARK
+
+/* Kernel workloads run over these buffer sizes. The largest is a 20ms DMA
+ * buffer at the top sample rate */
+#define BENCH_MAX_FRAMES (AUDIO_MAX_SAMPLE_RATE / 50)
+#define BENCH_RUNS 8 /**< Timed runs per workload, the fastest is kept */
+static const uint32_t benchFrames[] = { 64, 256, 960, BENCH_MAX_FRAMES };
+
+#if AUDIO_DMA_BYTES_PER_SAMPLE == 4
+typedef int32_t bench_sample_t;
+#else
+typedef int16_t bench_sample_t;
+#endif
+
+typedef enum {
+    KERNEL_COPY, /**< memcpy of the buffer, for reference */
+    KERNEL_GAIN_BYPASS, /**< GainApply at unity                  */
+    KERNEL_GAIN_STEADY, /**< GainApply at a fixed -6dB           */
+    KERNEL_GAIN_RAMP, /**< GainApply ramping at the start      */
+    KERNEL_PACK24 /**< SamplePack24, in place              */
+} bench_kernel_t;
+
+/* Live stage totals. Each stage has a single writer, and the reporter works
+ * on differences, so nothing needs resetting except the max */
+typedef struct {
+    volatile uint32_t calls;
+    volatile uint32_t cycles;
+    volatile uint32_t samples;
+    volatile uint32_t maxCycles;
+} bench_stat_t;
+
+static bench_stat_t stages[BENCH_STAGE_COUNT];
+static bench_stat_t lastStages[BENCH_STAGE_COUNT]; /**< Totals at the last report */
+static uint32_t lastReportCycles; /**< Cycle count at the last report */
+
+static bench_sample_t benchBuf[BENCH_MAX_FRAMES * AUDIO_NUM_CHANNELS];
+static bench_sample_t benchCopy[BENCH_MAX_FRAMES * AUDIO_NUM_CHANNELS];
+static gain_t benchGain;
+
+static uint32_t BenchKernel(bench_kernel_t kernel, uint32_t frames);
+
+/* Cycles per sample, in hundredths, as the two halves of a %u.%02u */
+#define BENCH_PER_SAMPLE(cycles, samples) \
+    (unsigned)(((cycles)*100u / (samples)) / 100), (unsigned)(((cycles)*100u / (samples)) % 100)
+
+/* One table row per kernel and buffer size. The label is pasted into the
+ * format so it survives binary logging */
+#define BENCH_ROW(label, kernel)                                                               \
+    for (i = 0; i < sizeof(benchFrames) / sizeof(benchFrames[0]); i++) {                       \
+        cycles = BenchKernel(kernel, benchFrames[i]);                                          \
+        LOG_MSG_INFO(BKGND, label " %5u frames %8u cycles %3u.%02u cyc/sample",                \
+                     (unsigned)benchFrames[i], (unsigned)cycles,                               \
+                     BENCH_PER_SAMPLE(cycles, benchFrames[i] * AUDIO_NUM_CHANNELS));           \
+    }
+
+/* One row of the live table, same idea */
+#define BENCH_STAGE_ROW(label, st)                                                           \
+    if (delta[st].calls != 0) {                                                              \
+        LOG_MSG_INFO(BKGND,                                                                  \
+                     label " %6u calls avg %6u max %6u cycles %3u.%02u cyc/sample "          \
+                           "%2u.%02u%% CPU",                                                 \
+                     (unsigned)delta[st].calls,                                              \
+                     (unsigned)(delta[st].cycles / delta[st].calls),                         \
+                     (unsigned)delta[st].maxCycles,                                          \
+                     BENCH_PER_SAMPLE((uint64_t)delta[st].cycles, delta[st].samples),        \
+                     BENCH_PER_SAMPLE((uint64_t)delta[st].cycles * 100, interval));          \
+    }
+
+void BenchRecord(bench_stage_t stage, uint32_t cycles, uint32_t samples)
+{
+    bench_stat_t *st = &stages[stage];
+
+    st->calls++;
+    st->cycles += cycles;
+    st->samples += samples;
+    if (cycles > st->maxCycles) {
+        st->maxCycles = cycles;
+    }
+}
+
+/**
+ * Times one kernel over a buffer size
+ * @param kernel - Workload to run
+ * @param frames - Buffer size in frames
+ * @returns Fewest cycles over BENCH_RUNS runs
+ */
+uint32_t BenchKernel(bench_kernel_t kernel, uint32_t frames)
+{
+    uint32_t samples = frames * AUDIO_NUM_CHANNELS;
+    uint32_t best = UINT32_MAX;
+    uint32_t start;
+    uint32_t cycles;
+    uint32_t ch;
+    int run;
+
+    GainInit(&benchGain);
+    for (run = 0; run < BENCH_RUNS; run++) {
+        //Fresh data each run, outside the timed part
+        memcpy(benchBuf, benchCopy, samples * sizeof(bench_sample_t));
+        for (ch = 0; ch < AUDIO_NUM_CHANNELS; ch++) {
+            if (kernel == KERNEL_GAIN_STEADY) {
+                GainSetTarget(&benchGain, ch, GainDbToQ15(-6 * 256));
+            } else if (kernel == KERNEL_GAIN_RAMP) {
+                GainSetTarget(&benchGain, ch, GainDbToQ15(((run & 1) ? -6 : -12) * 256));
+            }
+        }
+        if ((kernel == KERNEL_GAIN_STEADY) && (run == 0)) {
+            //Settle the ramp first
+            GainApply(&benchGain, benchBuf, BENCH_MAX_FRAMES);
+        }
+
+        start = CycleCounterGet();
+        switch (kernel) {
+        case KERNEL_COPY:
+            memcpy(benchBuf, benchCopy, samples * sizeof(bench_sample_t));
+            break;
+        case KERNEL_GAIN_BYPASS:
+        case KERNEL_GAIN_STEADY:
+        case KERNEL_GAIN_RAMP:
+            GainApply(&benchGain, benchBuf, frames);
+            break;
+        case KERNEL_PACK24:
+            SamplePack24(benchBuf, (const int32_t *)benchBuf, samples);
+            break;
+        }
+        cycles = CycleCounterGet() - start;
+        if (cycles < best) {
+            best = cycles;
+        }
+    }
+    return best;
+}
+
+void BenchRunKernels()
+{
+    uint32_t i;
+    uint32_t cycles;
+
+    CycleCounterInit();
+    //Something other than silence, so no kernel gets an easy ride
+    for (i = 0; i < BENCH_MAX_FRAMES * AUDIO_NUM_CHANNELS; i++) {
+        benchCopy[i] = (bench_sample_t)(i * 0x9E3779B1u);
+    }
+
+    LOG_MSG_INFO(BKGND, "Bench: %u ch, %u bit in %u byte subslots, %u MHz",
+                 (unsigned)AUDIO_NUM_CHANNELS, (unsigned)AUDIO_SAMPLE_BITS,
+                 (unsigned)AUDIO_BYTES_PER_SAMPLE, (unsigned)(CYCLE_COUNTER_HZ / 1000000));
+    BENCH_ROW("copy       ", KERNEL_COPY);
+    BENCH_ROW("gain bypass", KERNEL_GAIN_BYPASS);
+    BENCH_ROW("gain steady", KERNEL_GAIN_STEADY);
+    BENCH_ROW("gain ramp  ", KERNEL_GAIN_RAMP);
+#if (AUDIO_SAMPLE_BITS == 24) && (AUDIO_BYTES_PER_SAMPLE == 3)
+    BENCH_ROW("pack24     ", KERNEL_PACK24);
+#endif
+}
+
+void BenchReport()
+{
+    bench_stat_t delta[BENCH_STAGE_COUNT];
+    uint32_t now = CycleCounterGet();
+    uint32_t interval = now - lastReportCycles;
+    int i;
+
+    //CPU load is over the time since the last report
+    lastReportCycles = now;
+    if (interval == 0) {
+        interval = 1;
+    }
+
+    for (i = 0; i < BENCH_STAGE_COUNT; i++) {
+        delta[i].calls = stages[i].calls - lastStages[i].calls;
+        delta[i].cycles = stages[i].cycles - lastStages[i].cycles;
+        delta[i].samples = stages[i].samples - lastStages[i].samples;
+        delta[i].maxCycles = __atomic_exchange_n(&stages[i].maxCycles, 0, __ATOMIC_RELAXED);
+        lastStages[i].calls += delta[i].calls;
+        lastStages[i].cycles += delta[i].cycles;
+        lastStages[i].samples += delta[i].samples;
+        if ((delta[i].calls == 0) || (delta[i].samples == 0)) {
+            delta[i].calls = 0; //Nothing to show
+        }
+    }
+
+    BENCH_STAGE_ROW("DMA ISR   ", BENCH_DMA_ISR);
+    BENCH_STAGE_ROW("I2S buffer", BENCH_I2S_BUFFER);
+    BENCH_STAGE_ROW("USB packet", BENCH_USB_PACKET);
+}
+
+#endif
@@ -0,0 +1,71 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_BENCHMARK_H_
+#define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_BENCHMARK_H_
+
+#include <stdint.h>
+#include "CycleCounter.h"
+
+/**
+ * Cycle counting for the pipeline's hot paths. With AUDIO_BENCHMARK set, the
+ * DMA ISR, the I2S task's per buffer work and the USB packet callback are
+ * timed on every call, and a fixed set of kernel workloads is run once at
+ * startup. Results are logged as tables of cycles per call and per sample, so
+ * builds can be compared line for line.
+ */
+#ifndef AUDIO_BENCHMARK
+#define AUDIO_BENCHMARK 0
+#endif
+
+/** Live pipeline stages */
+typedef enum {
+    BENCH_DMA_ISR, /**< I2S_DMA_Callback                   */
+    BENCH_I2S_BUFFER, /**< Gain and format of one DMA buffer  */
+    BENCH_USB_PACKET, /**< tud_audio_tx_done_pre_load_cb      */
+    BENCH_STAGE_COUNT
+} bench_stage_t;
+
+#if AUDIO_BENCHMARK
+#define BENCH_START() uint32_t benchStart = CycleCounterGet()
+#define BENCH_END(stage, samples) BenchRecord(stage, CycleCounterGet() - benchStart, samples)
+#else
+#define BENCH_START()
+#define BENCH_END(stage, samples)
+#endif
+
+/**
+ * Adds one timed call to a stage. Each stage must only be timed from one
+ * context (its ISR or task)
+ * @param stage - Stage the call belongs to
+ * @param cycles - Cycles the call took
+ * @param samples - Samples it processed
+ */
+void BenchRecord(bench_stage_t stage, uint32_t cycles, uint32_t samples);
+
+/**
+ * Runs the fixed kernel workloads and logs their table. Takes a few tens of
+ * milliseconds of CPU, so call it before streaming starts
+ */
+void BenchRunKernels(void);
+
+/**
+ * Logs the live stage table for the calls since the last report
+ */
+void BenchReport(void);
+
+#endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_BENCHMARK_H_
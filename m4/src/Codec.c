@@ -0,0 +1,475 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#include "Codec.h"
+
+#include <stdbool.h>
+
+#include "AudioConfig.h"
+#include "Logging.h"
+#include "TaskPriorities.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+
+#include "mxc_device.h"
+#include "mxc_errors.h"
+#include "i2c.h"
+#include "i2c_regs.h"
+
+#define CODEC_I2C MXC_I2C2
+#define CODEC_I2C_IRQn I2C2_IRQn
+#define MAX9867_ADDR 0x18
+
+#define CODEC_MCLOCK 12288000
+
+/* MCLK is prescaled into 10-20MHz, so PCLK = MCLK here */
+#define CODEC_PCLK CODEC_MCLOCK
+
+/* Writable register map. 0x00-0x03 are read only status */
+#define CODEC_REG_FIRST 0x04
+#define CODEC_REG_LAST 0x17
+#define CODEC_NUM_REGS (CODEC_REG_LAST + 1)
+
+/* Register operations waiting for the codec task */
+#define CODEC_QUEUE_ITEMS 16
+
+/* A transaction at 100kHz is well under 2ms, this only catches a stuck bus */
+#define CODEC_I2C_TIMEOUT_MS 20
+
+/* Operations run by the codec task, in the order they were queued */
+typedef enum {
+    CODEC_OP_UPDATE, /**< Set the bits of mask in reg, dirty only if changed */
+    CODEC_OP_WRITE, /**< Set reg and mark it dirty regardless */
+    CODEC_OP_TABLE, /**< CODEC_OP_UPDATE for every entry of a table */
+    CODEC_OP_RESET, /**< Set the whole map to POR values, all dirty */
+    CODEC_OP_GAIN, /**< Apply the latest input gain */
+    CODEC_OP_FLUSH, /**< Write out dirty registers before anything after it */
+    CODEC_OP_SYNC, /**< Flush and signal everything queued before it is done */
+} codec_op_type_t;
+
+/* One register setting. Configurations are const tables of these */
+typedef struct {
+    uint8_t reg;
+    uint8_t mask;
+    uint8_t val;
+} codec_reg_t;
+
+typedef struct {
+    uint8_t type;
+    codec_reg_t set; /**< UPDATE and WRITE */
+    const codec_reg_t *table; /**< TABLE only */
+    uint32_t count; /**< Entries in table */
+} codec_op_t;
+
+/* Line in capture format. Everything not listed stays at POR */
+static const codec_reg_t configTable[] = {
+    { 0x08, 0xFF, 0x98 }, //I2S format, data is delayed 1 bit clock, HI-Z mode disabled
+#if AUDIO_SAMPLE_BITS == 24
+    { 0x09, 0xFF, 0x01 }, //BCLK 64x LRCLK, room for 24 bits + the I2S delay
+#else
+    { 0x09, 0xFF, 0x02 }, //BCLK 48x LRCLK
+#endif
+    { 0x0A, 0xFF, 0x90 }, //Audio filters
+    { 0x14, 0xFF, 0xA0 }, //Stereo Line In
+    { 0x15, 0xFF, 0x00 },
+};
+
+/* Enable ADCs and Line In, and leave shutdown */
+static const codec_reg_t enableTable[] = {
+    { 0x17, 0xE3, 0x80 | 0x1 | 0x2 | 0x20 | 0x40 },
+};
+
+static void CodecUpdateReg(uint8_t reg, uint8_t mask, uint8_t val);
+static void CodecWriteReg(uint8_t reg, uint8_t val);
+static void CodecApplyTable(const codec_reg_t *table, uint32_t count);
+static void CodecFlush(void);
+static void CodecSync(void);
+static void CodecQueueOp(const codec_op_t *op);
+static void CodecWriteClocking(uint32_t sampleRate);
+static void CodecTaskBody(void *param);
+static void CodecRunOp(const codec_op_t *op);
+static void CodecShadowSet(uint8_t reg, uint8_t mask, uint8_t val, bool force);
+static void CodecShadowFlush(void);
+static void CodecWriteGain(void);
+static int CodecBusWrite(uint8_t *tx, uint32_t txLen);
+static void CodecI2C_Callback(mxc_i2c_req_t *req, int result);
+
+static TaskHandle_t taskHandle;
+static QueueHandle_t opQueue;
+static SemaphoreHandle_t syncSem;
+
+/* Input gain the codec should be at, in dB. Written by any task, applied by
+ * the codec task */
+static volatile int8_t inputGain[AUDIO_NUM_CHANNELS];
+static volatile bool gainDirty;
+
+/* What the codec registers hold, or will once flushed. Codec task only. The
+ * register address rides in front of the data so a run can be sent in place */
+static uint8_t shadow[CODEC_NUM_REGS + 1];
+static uint32_t dirty; /**< Bit per register */
+static uint32_t busTransactions; /**< Since power up, for diagnostics */
+
+static mxc_i2c_req_t i2c_req;
+static volatile int i2cResult;
+
+/* I2C interrupt, drives the async transactions */
+void I2C2_IRQHandler(void)
+{
+    MXC_I2C_AsyncHandler(CODEC_I2C);
+}
+
+void CodecInit()
+{
+    uint32_t ch;
+    codec_op_t op = { .type = CODEC_OP_RESET };
+
+    opQueue = xQueueCreate(CODEC_QUEUE_ITEMS, sizeof(codec_op_t));
+    syncSem = xSemaphoreCreateBinary();
+
+    NVIC_SetPriority(CODEC_I2C_IRQn, 7); //Play nice with FreeRTOS
+    NVIC_EnableIRQ(CODEC_I2C_IRQn);
+
+    xTaskCreate(CodecTaskBody, "Codec", 512, NULL, TASK_PRIO_CODEC, &taskHandle);
+
+    //Shutdown for configuration. The codec may still be running from before
+    //a reset, so this goes out on its own
+    CodecWriteReg(0x17, 0x00);
+    CodecFlush();
+
+    //Everything else from POR, as one burst
+    CodecQueueOp(&op);
+    CodecApplyTable(configTable, sizeof(configTable) / sizeof(configTable[0]));
+    CodecWriteClocking(AUDIO_SAMPLE_RATE);
+    for (ch = 0; ch < AUDIO_NUM_CHANNELS; ch++) {
+        inputGain[ch] = CODEC_GAIN_DEFAULT_DB;
+    }
+    gainDirty = true;
+    op.type = CODEC_OP_GAIN; //ADC level and line in gain
+    CodecQueueOp(&op);
+    CodecFlush();
+
+    CodecApplyTable(enableTable, sizeof(enableTable) / sizeof(enableTable[0]));
+
+    //The rest of the system expects a running codec
+    CodecSync();
+    LOG_MSG_INFO(CODEC, "Configured in %u I2C transactions", (unsigned)busTransactions);
+}
+
+void CodecSetInputGain(uint32_t channel, int32_t db)
+{
+    codec_op_t op = { .type = CODEC_OP_GAIN };
+
+    if (channel >= AUDIO_NUM_CHANNELS) {
+        return;
+    }
+    if (db > CODEC_GAIN_MAX_DB) {
+        db = CODEC_GAIN_MAX_DB;
+    } else if (db < CODEC_GAIN_MIN_DB) {
+        db = CODEC_GAIN_MIN_DB;
+    }
+    inputGain[channel] = (int8_t)db;
+
+    //One queued gain update picks up every change made before it runs
+    if (!gainDirty) {
+        gainDirty = true;
+        CodecQueueOp(&op);
+    }
+}
+
+void CodecSetSampleRate(uint32_t sampleRate)
+{
+    //Clocks may only change while in shutdown, so each step is flushed
+    //before the next
+    CodecUpdateReg(0x17, 0x80, 0x00);
+    CodecFlush();
+    CodecWriteClocking(sampleRate);
+    CodecFlush();
+    CodecUpdateReg(0x17, 0x80, 0x80);
+    CodecSync();
+
+    LOG_MSG_INFO(CODEC, "Sample rate %u Hz", (unsigned)sampleRate);
+}
+
+/**
+ * Programs the prescaler, LRCLK divider and filter rate mode for a sample rate.
+ * Rates above 48kHz need the DHF mode, which halves the NI multiplier.
+ * @param sampleRate - Sample rate in Hz
+ */
+void CodecWriteClocking(uint32_t sampleRate)
+{
+    uint32_t mult = (sampleRate > 48000) ? 48 : 96;
+    uint32_t ni = (uint32_t)(((uint64_t)65536 * mult * sampleRate) / CODEC_PCLK);
+
+    CodecUpdateReg(0x05, 0xFF, 0x1 << 4); //Prescaler for 12.2MHz clock
+    CodecUpdateReg(0x06, 0xFF, (ni >> 8) & 0x7F); //NI high, PLL off. 0x6000 at 48kHz
+    CodecUpdateReg(0x07, 0xFF, ni & 0xFF); //NI low
+    CodecUpdateReg(0x0A, 0x08, (sampleRate > 48000) ? 0x08 : 0x00); //DHF
+}
+
+/**
+ * Queues a change to the bits in mask. Only the shadow changes until a flush
+ */
+void CodecUpdateReg(uint8_t reg, uint8_t mask, uint8_t val)
+{
+    codec_op_t op = { .type = CODEC_OP_UPDATE, .set = { reg, mask, val } };
+
+    CodecQueueOp(&op);
+}
+
+/**
+ * Queues a register write that goes out at the next flush even if the shadow
+ * already holds the value
+ */
+void CodecWriteReg(uint8_t reg, uint8_t val)
+{
+    codec_op_t op = { .type = CODEC_OP_WRITE, .set = { reg, 0xFF, val } };
+
+    CodecQueueOp(&op);
+}
+
+/**
+ * Queues a const configuration table. The table must outlive the operation
+ */
+void CodecApplyTable(const codec_reg_t *table, uint32_t count)
+{
+    codec_op_t op = { .type = CODEC_OP_TABLE, .table = table, .count = count };
+
+    CodecQueueOp(&op);
+}
+
+/**
+ * Queues an ordering point. Dirty registers are written before any operation
+ * queued after it
+ */
+void CodecFlush()
+{
+    codec_op_t op = { .type = CODEC_OP_FLUSH };
+
+    CodecQueueOp(&op);
+}
+
+/**
+ * Blocks the calling task, without spinning, until everything it queued has
+ * reached the codec
+ */
+void CodecSync()
+{
+    codec_op_t op = { .type = CODEC_OP_SYNC };
+
+    CodecQueueOp(&op);
+    xSemaphoreTake(syncSem, portMAX_DELAY);
+}
+
+void CodecQueueOp(const codec_op_t *op)
+{
+    xQueueSend(opQueue, op, portMAX_DELAY);
+}
+
+/**
+ * Owns the I2C bus. Wakes on the first queued operation and applies everything
+ * queued behind it to the shadow, then writes out whatever ended up dirty.
+ * While a transaction is on the bus the task is blocked, so the I2S and USB
+ * tasks get the CPU.
+ */
+void CodecTaskBody(void *param)
+{
+    codec_op_t op;
+
+    while (1) {
+        if (xQueueReceive(opQueue, &op, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        do {
+            CodecRunOp(&op);
+        } while (xQueueReceive(opQueue, &op, 0) == pdTRUE);
+        CodecShadowFlush();
+    }
+}
+
+void CodecRunOp(const codec_op_t *op)
+{
+    uint32_t i;
+
+    switch (op->type) {
+    case CODEC_OP_UPDATE:
+    case CODEC_OP_WRITE:
+        CodecShadowSet(op->set.reg, op->set.mask, op->set.val, op->type == CODEC_OP_WRITE);
+        break;
+    case CODEC_OP_TABLE:
+        for (i = 0; i < op->count; i++) {
+            CodecShadowSet(op->table[i].reg, op->table[i].mask, op->table[i].val, false);
+        }
+        break;
+    case CODEC_OP_RESET:
+        for (i = CODEC_REG_FIRST; i <= CODEC_REG_LAST; i++) {
+            CodecShadowSet(i, 0xFF, 0x00, true);
+        }
+        break;
+    case CODEC_OP_GAIN:
+        gainDirty = false;
+        CodecWriteGain();
+        break;
+    case CODEC_OP_FLUSH:
+        CodecShadowFlush();
+        break;
+    case CODEC_OP_SYNC:
+        CodecShadowFlush();
+        xSemaphoreGive(syncSem);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * Splits each channel's gain into line in gain (the coarse 2dB steps) and ADC
+ * level (the remaining dB), and sets both. Mono drives both sides the same.
+ */
+void CodecWriteGain()
+{
+    int32_t line[2];
+    int32_t adc[2];
+    int32_t db;
+    uint32_t ch;
+
+    for (ch = 0; ch < 2; ch++) {
+        db = inputGain[(ch < AUDIO_NUM_CHANNELS) ? ch : 0];
+        //Even dB at or below the gain, within the line in range. The ADC level
+        //makes up the rest, which the gain limits keep within +3 to -12dB
+        line[ch] = (db >= 0) ? (db & ~1) : -((-db + 1) & ~1);
+        if (line[ch] > 24) {
+            line[ch] = 24;
+        } else if (line[ch] < -6) {
+            line[ch] = -6;
+        }
+        adc[ch] = db - line[ch];
+    }
+
+    //ADC level, left in the high nibble
+    CodecShadowSet(0x0D, 0xFF, ((3 - adc[0]) << 4) | (3 - adc[1]), false);
+    //Line in, disconnected from headphones
+    CodecShadowSet(0x0E, 0xFF, 0x40 | ((24 - line[0]) / 2), false);
+    CodecShadowSet(0x0F, 0xFF, 0x40 | ((24 - line[1]) / 2), false);
+}
+
+/**
+ * Changes the bits of mask in the shadow copy of a register
+ * @param force - Mark dirty even if the value didn't change
+ */
+void CodecShadowSet(uint8_t reg, uint8_t mask, uint8_t val, bool force)
+{
+    uint8_t next;
+
+    if ((reg < CODEC_REG_FIRST) || (reg > CODEC_REG_LAST)) {
+        return;
+    }
+    next = (shadow[reg + 1] & ~mask) | (val & mask);
+    if (force || (next != shadow[reg + 1])) {
+        shadow[reg + 1] = next;
+        dirty |= 1UL << reg;
+    }
+}
+
+/**
+ * Writes out every dirty register. Runs of dirty registers, and the short
+ * clean gaps between them, go out as single auto-increment bursts straight
+ * from the shadow. The MAX9867 steps the register address on every data byte.
+ */
+void CodecShadowFlush()
+{
+    uint32_t first;
+    uint32_t last;
+    uint32_t reg;
+    uint8_t save;
+    int err;
+
+    reg = CODEC_REG_FIRST;
+    while (dirty != 0) {
+        //Start of the next run
+        while ((dirty & (1UL << reg)) == 0) {
+            reg++;
+        }
+        first = reg;
+        last = reg;
+        for (reg = first + 1; (reg <= CODEC_REG_LAST) && (reg <= last + CODEC_BRIDGE_REGS + 1);
+             reg++) {
+            if (dirty & (1UL << reg)) {
+                last = reg;
+            }
+        }
+
+        //The byte in front of the run is borrowed for the register address
+        save = shadow[first];
+        shadow[first] = (uint8_t)first;
+        err = CodecBusWrite(&shadow[first], 2 + last - first);
+        shadow[first] = save;
+        if (err != E_NO_ERROR) {
+            LOG_MSG_ERR(CODEC, "Write of 0x%02X-0x%02X failed: %d", (unsigned)first,
+                        (unsigned)last, err);
+        }
+
+        dirty &= ~(((1UL << (last + 1)) - 1) & ~((1UL << first) - 1));
+        reg = last + 1;
+    }
+}
+
+/**
+ * Runs one I2C write from the interrupt handler, and blocks the codec task
+ * until it completes
+ * @returns E_NO_ERROR, or the driver error
+ */
+int CodecBusWrite(uint8_t *tx, uint32_t txLen)
+{
+    int err;
+
+    i2c_req.i2c = CODEC_I2C;
+    i2c_req.addr = MAX9867_ADDR;
+    i2c_req.restart = 0;
+    i2c_req.callback = CodecI2C_Callback;
+    i2c_req.tx_buf = tx;
+    i2c_req.tx_len = txLen;
+    i2c_req.rx_buf = NULL;
+    i2c_req.rx_len = 0;
+
+    busTransactions++;
+
+    //Drop any stale completion before starting
+    ulTaskNotifyTake(pdTRUE, 0);
+    err = MXC_I2C_MasterTransactionAsync(&i2c_req);
+    if (err != E_NO_ERROR) {
+        return err;
+    }
+    if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(CODEC_I2C_TIMEOUT_MS)) == 0) {
+        MXC_I2C_AbortAsync(&i2c_req);
+        return E_TIME_OUT;
+    }
+    return i2cResult;
+}
+
+/**
+ * Called from the I2C interrupt when a transaction finishes
+ */
+void CodecI2C_Callback(mxc_i2c_req_t *req, int result)
+{
+    BaseType_t higherTaskWoken = pdFALSE;
+
+    i2cResult = result;
+    vTaskNotifyGiveFromISR(taskHandle, &higherTaskWoken);
+}
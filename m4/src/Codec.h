@@ -0,0 +1,63 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_CODEC_H_
+#define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_CODEC_H_
+
+#include <stdint.h>
+
+/* Hardware input gain range, line in (+24 to -6dB in 2dB steps) plus ADC level
+ * (+3 to -12dB in 1dB steps), giving 1dB steps overall */
+#define CODEC_GAIN_MAX_DB 27
+#define CODEC_GAIN_MIN_DB -18
+
+/* Gain at power up, line in -6dB and ADC -12dB, with room for line level */
+#define CODEC_GAIN_DEFAULT_DB CODEC_GAIN_MIN_DB
+
+/* A register flush keeps a burst going across up to this many clean
+ * registers. Resending a byte is no dearer on the bus than the address and
+ * register overhead of a new transaction, and saves an interrupt. It pays off
+ * when a right channel gain change moves 0x0D and 0x0F but not 0x0E */
+#ifndef CODEC_BRIDGE_REGS
+#define CODEC_BRIDGE_REGS 2
+#endif
+
+/**
+ * Configures the MAX9867 for stereo line in capture at AUDIO_SAMPLE_RATE.
+ * Starts the codec task, which owns the I2C bus from then on. Blocks (without
+ * spinning) until the codec is configured and running.
+ */
+void CodecInit(void);
+
+/**
+ * Requests a new hardware input gain for a channel. Returns immediately, the
+ * registers are written later by the codec task. Back to back requests
+ * collapse into a single update.
+ * @param channel - Zero based channel index
+ * @param db - Gain in dB, clamped to CODEC_GAIN_MIN_DB..CODEC_GAIN_MAX_DB
+ */
+void CodecSetInputGain(uint32_t channel, int32_t db);
+
+/**
+ * Reprograms the codec clocking for a new sample rate. The codec is shut down
+ * while the clocks change, so LRCLK/BCLK stop briefly. The calling task sleeps
+ * until the codec task has written the registers.
+ * @param sampleRate - New sample rate in Hz, one of AUDIO_SAMPLE_RATES
+ */
+void CodecSetSampleRate(uint32_t sampleRate);
+
+#endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_CODEC_H_
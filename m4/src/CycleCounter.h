@@ -0,0 +1,76 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_CYCLECOUNTER_H_
+#define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_CYCLECOUNTER_H_
+
+#include <stdint.h>
+
+/**
+ * Core cycle counter (DWT CYCCNT) for timing. One cycle resolution, and at
+ * 120MHz it wraps every ~35 seconds, so unsigned differences are good for any
+ * interval shorter than that.
+ *
+ * Built for the host (no __arm__), the same calls read the monotonic clock
+ * and a "cycle" is a nanosecond, so a host harness gets comparable numbers.
+ */
+#if defined(__arm__)
+#include "mxc_device.h"
+#define CYCLE_COUNTER_HZ SystemCoreClock
+#else
+#include <time.h>
+#define CYCLE_COUNTER_HZ 1000000000u
+#endif
+
+/**
+ * Enables the counter. Safe to call more than once
+ */
+static inline void CycleCounterInit(void)
+{
+#if defined(__arm__)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+/**
+ * Gets the current cycle count
+ * @returns Core clock cycles, free running
+ */
+static inline uint32_t CycleCounterGet(void)
+{
+#if defined(__arm__)
+    return DWT->CYCCNT;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+#endif
+}
+
+/**
+ * Converts a cycle count to microseconds
+ * @param cycles - Cycles, usually a difference of two CycleCounterGet()s
+ * @returns Microseconds
+ */
+static inline uint32_t CycleCounterToUs(uint32_t cycles)
+{
+    return cycles / (CYCLE_COUNTER_HZ / 1000000);
+}
+
+#endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_CYCLECOUNTER_H_
@@ -0,0 +1,47 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#include "FaultInject.h"
+#include "CycleCounter.h"
+
+#if AUDIO_FAULT_INJECT
+
+static uint32_t rngState = 0x2545F491;
+
+uint32_t FaultInjectRandom()
+{
+    //xorshift32
+    uint32_t x = rngState;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    rngState = x;
+    return x;
+}
+
+void FaultInjectSpin(uint32_t maxUs)
+{
+    uint32_t cycles = (FaultInjectRandom() % (maxUs + 1)) * (CYCLE_COUNTER_HZ / 1000000);
+    uint32_t start;
+
+    CycleCounterInit();
+    start = CycleCounterGet();
+    while ((CycleCounterGet() - start) < cycles) {}
+}
+
+#endif
@@ -0,0 +1,91 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_FAULTINJECT_H_
+#define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_FAULTINJECT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Fault injection for soak testing the capture path. With AUDIO_FAULT_INJECT
+ * set, the pipeline randomly stalls the I2S task, delays the DMA reload,
+ * forces DMA overruns and skips USB packets, at the rates below. Injected
+ * faults are counted in AudioStats, and the stats report adds a soak verdict:
+ * anything going wrong that wasn't injected is a failure.
+ *
+ * Rates are per mille of the events they hit: DMA buffers for the I2S and DMA
+ * faults, USB packets for the USB one. All can be overridden from the build.
+ */
+#ifndef AUDIO_FAULT_INJECT
+#define AUDIO_FAULT_INJECT 0
+#endif
+
+#ifndef FAULT_I2S_STALL_PERMILLE
+#define FAULT_I2S_STALL_PERMILLE 5 /**< I2S task sleeps before handing over */
+#endif
+#ifndef FAULT_I2S_STALL_MAX_MS
+#define FAULT_I2S_STALL_MAX_MS 30
+#endif
+#ifndef FAULT_DMA_DELAY_PERMILLE
+#define FAULT_DMA_DELAY_PERMILLE 10 /**< DMA ISR spins before the reload */
+#endif
+#ifndef FAULT_DMA_DELAY_MAX_US
+#define FAULT_DMA_DELAY_MAX_US 200
+#endif
+#ifndef FAULT_DMA_OVERRUN_PERMILLE
+#define FAULT_DMA_OVERRUN_PERMILLE 2 /**< DMA ISR acts as if no buffer was free */
+#endif
+#ifndef FAULT_USB_SKIP_PERMILLE
+#define FAULT_USB_SKIP_PERMILLE 1 /**< A packet goes out as silence, no data taken */
+#endif
+
+/** Latency the soak verdict allows, with AUDIO_MEASURE_LATENCY */
+#ifndef AUDIO_SOAK_MAX_LATENCY_US
+#define AUDIO_SOAK_MAX_LATENCY_US 80000
+#endif
+
+#if AUDIO_FAULT_INJECT
+#define FAULT_HIT(name) FaultInjectHit(name##_PERMILLE)
+#else
+#define FAULT_HIT(name) false
+#endif
+
+/**
+ * Gets a pseudo random number. Safe from any context; an ISR racing a task
+ * only costs some randomness
+ * @returns 32 random bits
+ */
+uint32_t FaultInjectRandom(void);
+
+/**
+ * Decides whether to inject a fault
+ * @param permille - Chance, in tenths of a percent
+ * @returns true to inject
+ */
+static inline bool FaultInjectHit(uint32_t permille)
+{
+    return (permille != 0) && ((FaultInjectRandom() % 1000) < permille);
+}
+
+/**
+ * Busy waits, for faults that hold the CPU (e.g. in an ISR)
+ * @param maxUs - Longest wait, the actual one is random up to this
+ */
+void FaultInjectSpin(uint32_t maxUs);
+
+#endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_FAULTINJECT_H_
@@ -0,0 +1,214 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#include "Gain.h"
+
+#include <stdbool.h>
+
+#if defined(__ARM_FEATURE_DSP)
+#include <arm_acle.h>
+#include "cmsis_compiler.h"
+#define MUL_BB(x, g) __smulbb(x, g)
+#define MUL_TT(x, g) __smultt(x, g)
+#define MUL_WB(x, g) __smulwb(x, g)
+#define PACK_HALVES(lo, hi, shift) __PKHBT(lo, hi, shift)
+#else
+/* Portable reference for the M4 DSP multiplies, bit exact with SMULxy/SMULWB */
+#define MUL_BB(x, g) ((int32_t)(int16_t)(x) * (int16_t)(g))
+#define MUL_TT(x, g) ((int32_t)(int16_t)((uint32_t)(x) >> 16) * (int16_t)((uint32_t)(g) >> 16))
+#define MUL_WB(x, g) ((int32_t)(((int64_t)(int32_t)(x) * (int16_t)(g)) >> 16))
+#define PACK_HALVES(lo, hi, shift) (((lo)&0x0000FFFFUL) | (((hi) << (shift)) & 0xFFFF0000UL))
+#endif
+
+#if AUDIO_DMA_BYTES_PER_SAMPLE == 4
+typedef int32_t gain_sample_t;
+#else
+typedef int16_t gain_sample_t;
+#endif
+
+/* 0dB down to GAIN_MIN_DB in 1dB steps, round(32768 * 10^(-dB/20)) */
+static const int16_t dbTable[1 - GAIN_MIN_DB] = {
+    32767, 29205, 26029, 23198, 20675, 18427, 16423, 14637, 13045, 11627, 10362, 9235, 8231,
+    7336,  6538,  5827,  5193,  4629,  4125,  3677,  3277,  2920,  2603,  2320,  2068, 1843,
+    1642,  1464,  1305,  1163,  1036,  924,   823,   734,   654,   583,   519,   463,  413,
+    368,   328,   292,   260,   232,   207,   184,   164,   146,   130,   116,   104,  92,
+    82,    73,    65,    58,    52,    46,    41,    37,    33,
+};
+
+static uint32_t GainRamp(gain_t *gain, gain_sample_t *data, uint32_t frames);
+static void GainSteady(const gain_t *gain, gain_sample_t *data, uint32_t frames);
+
+/**
+ * Scales a single sample. The 24 bit path drops the product's low bits back
+ * to the 24-in-32 format, so both routes through SMULWB agree.
+ */
+static inline gain_sample_t GainSample(gain_sample_t x, int32_t g)
+{
+#if AUDIO_DMA_BYTES_PER_SAMPLE == 4
+    return (gain_sample_t)(((uint32_t)MUL_WB(x, g) << 1) & 0xFFFFFF00UL);
+#else
+    return (gain_sample_t)(MUL_BB(x, g) >> 15);
+#endif
+}
+
+void GainInit(gain_t *gain)
+{
+    uint32_t ch;
+
+    for (ch = 0; ch < AUDIO_NUM_CHANNELS; ch++) {
+        gain->target[ch] = GAIN_UNITY;
+        gain->rampTarget[ch] = GAIN_UNITY;
+        gain->current[ch] = (int32_t)GAIN_UNITY << 16;
+        gain->step[ch] = 0;
+    }
+}
+
+int16_t GainDbToQ15(int32_t volume)
+{
+    int32_t db;
+
+    if (volume >= 0) {
+        return GAIN_UNITY;
+    }
+    db = (-volume + 128) / 256;
+    if (db > -GAIN_MIN_DB) {
+        db = -GAIN_MIN_DB;
+    }
+    return dbTable[db];
+}
+
+void GainSetTarget(gain_t *gain, uint32_t channel, int16_t q15)
+{
+    if (channel < AUDIO_NUM_CHANNELS) {
+        gain->target[channel] = q15;
+    }
+}
+
+void GainApply(gain_t *gain, void *data, uint32_t frames)
+{
+    gain_sample_t *samples = (gain_sample_t *)data;
+    uint32_t done;
+    uint32_t ch;
+    bool unity = true;
+
+    //Pick up new targets. The ramp always takes GAIN_RAMP_FRAMES from where
+    //the gain is now, even if the previous ramp hadn't finished
+    for (ch = 0; ch < AUDIO_NUM_CHANNELS; ch++) {
+        if (gain->target[ch] != gain->rampTarget[ch]) {
+            gain->rampTarget[ch] = gain->target[ch];
+            gain->step[ch] =
+                (((int32_t)gain->rampTarget[ch] << 16) - gain->current[ch]) / GAIN_RAMP_FRAMES;
+            if (gain->step[ch] == 0) {
+                gain->step[ch] = (gain->rampTarget[ch] > (gain->current[ch] >> 16)) ? 1 : -1;
+            }
+        }
+    }
+
+    done = GainRamp(gain, samples, frames);
+    samples += done * AUDIO_NUM_CHANNELS;
+    frames -= done;
+
+    for (ch = 0; ch < AUDIO_NUM_CHANNELS; ch++) {
+        unity = unity && (gain->rampTarget[ch] == GAIN_UNITY);
+    }
+    if ((frames > 0) && !unity) {
+        GainSteady(gain, samples, frames);
+    }
+}
+
+/**
+ * Runs any ramps in progress, one gain per frame, until they all land
+ * @returns Number of frames processed
+ */
+uint32_t GainRamp(gain_t *gain, gain_sample_t *data, uint32_t frames)
+{
+    uint32_t i;
+    uint32_t ch;
+    int32_t end;
+    bool ramping;
+
+    for (i = 0; i < frames; i++) {
+        ramping = false;
+        for (ch = 0; ch < AUDIO_NUM_CHANNELS; ch++) {
+            end = (int32_t)gain->rampTarget[ch] << 16;
+            if (gain->current[ch] != end) {
+                gain->current[ch] += gain->step[ch];
+                if (((gain->step[ch] > 0) && (gain->current[ch] > end)) ||
+                    ((gain->step[ch] < 0) && (gain->current[ch] < end))) {
+                    gain->current[ch] = end;
+                }
+                ramping = true;
+            }
+        }
+        if (!ramping) {
+            break;
+        }
+        for (ch = 0; ch < AUDIO_NUM_CHANNELS; ch++) {
+            data[ch] = GainSample(data[ch], gain->current[ch] >> 16);
+        }
+        data += AUDIO_NUM_CHANNELS;
+    }
+    return i;
+}
+
+/**
+ * Applies a constant gain once all ramps are done. 16 bit samples go two per
+ * word through SMULBB/SMULTT, so stereo costs one load, two multiplies, a pack
+ * and a store per frame.
+ */
+void GainSteady(const gain_t *gain, gain_sample_t *data, uint32_t frames)
+{
+#if AUDIO_DMA_BYTES_PER_SAMPLE == 4
+    uint32_t i;
+    uint32_t ch;
+
+    for (i = 0; i < frames; i++) {
+        for (ch = 0; ch < AUDIO_NUM_CHANNELS; ch++) {
+            data[ch] = GainSample(data[ch], gain->rampTarget[ch]);
+        }
+        data += AUDIO_NUM_CHANNELS;
+    }
+#else
+    uint32_t *words;
+    uint32_t count = frames * AUDIO_NUM_CHANNELS;
+    uint32_t g;
+    uint32_t w;
+    uint32_t i;
+
+#if AUDIO_NUM_CHANNELS == 1
+    //A ramp can end on an odd frame, so take a sample on its own to get the
+    //word loop aligned. Both halves of g are the same gain in mono
+    if (((uintptr_t)data & 2) && (count > 0)) {
+        *data = GainSample(*data, gain->rampTarget[0]);
+        data++;
+        count--;
+    }
+#endif
+    words = (uint32_t *)data;
+
+    //Low half is the even sample, left for stereo
+    g = PACK_HALVES((uint32_t)(uint16_t)gain->rampTarget[0],
+                    (uint32_t)(uint16_t)gain->rampTarget[AUDIO_NUM_CHANNELS - 1], 16);
+    for (i = count / 2; i > 0; i--) {
+        w = *words;
+        *words++ = PACK_HALVES((uint32_t)(MUL_BB(w, g) >> 15), (uint32_t)(MUL_TT(w, g) >> 15), 16);
+    }
+    if (count & 1) {
+        data[count - 1] = GainSample(data[count - 1], gain->rampTarget[0]);
+    }
+#endif
+}
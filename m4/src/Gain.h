@@ -0,0 +1,77 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_GAIN_H_
+#define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_GAIN_H_
+
+#include <stdint.h>
+#include "AudioConfig.h"
+
+/* Gains are Q15. Q15 can't hold 1.0, so unity is the largest value, and a
+ * stage sitting at unity is skipped so the data passes through untouched */
+#define GAIN_UNITY 0x7FFF
+#define GAIN_MUTE 0
+
+/* Lowest gain in the dB table. Anything below this is treated as the minimum */
+#define GAIN_MIN_DB -60
+
+/* Frames a gain change is spread over, about 5ms at 48kHz */
+#define GAIN_RAMP_FRAMES 256
+
+/* Per channel gain state. target is written by whoever sets the gain; the
+ * rest belongs to GainApply */
+typedef struct {
+    volatile int16_t target[AUDIO_NUM_CHANNELS]; /**< Requested gain, Q15 */
+    int16_t rampTarget[AUDIO_NUM_CHANNELS]; /**< Target the ramp was set up for */
+    int32_t current[AUDIO_NUM_CHANNELS]; /**< Applied gain, Q15 in bits 31:16 */
+    int32_t step[AUDIO_NUM_CHANNELS]; /**< Per frame ramp step, same format */
+} gain_t;
+
+/**
+ * Initializes all channels to unity gain
+ * @param gain - Gain state to initialize
+ */
+void GainInit(gain_t *gain);
+
+/**
+ * Converts a UAC2 volume to a Q15 gain, rounded to the nearest dB. Positive
+ * volumes are clamped to unity, and anything below GAIN_MIN_DB to the minimum.
+ * @param volume - Volume in 1/256 dB
+ * @returns Q15 gain
+ */
+int16_t GainDbToQ15(int32_t volume);
+
+/**
+ * Sets the gain a channel ramps to. Safe to call while another task is in
+ * GainApply; the change is picked up at the next buffer.
+ * @param gain - Gain state
+ * @param channel - Zero based channel index
+ * @param q15 - New gain, GAIN_MUTE to GAIN_UNITY
+ */
+void GainSetTarget(gain_t *gain, uint32_t channel, int16_t q15);
+
+/**
+ * Applies the gain in place to a buffer of interleaved DMA format samples
+ * (16 bit, or 24-in-32 MSB aligned). Changes ramp linearly per frame over
+ * GAIN_RAMP_FRAMES. Gains never exceed unity, so nothing can clip.
+ * @param gain - Gain state
+ * @param data - Samples, 4 byte aligned
+ * @param frames - Number of frames
+ */
+void GainApply(gain_t *gain, void *data, uint32_t frames);
+
+#endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_GAIN_H_
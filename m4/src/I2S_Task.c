@@ -16,6 +16,14 @@
  *
  ******************************************************************************/
 #include "I2S_Task.h"
+#include "AudioConfig.h"
+#include "AudioStats.h"
+#include "CycleCounter.h"
+#include "Benchmark.h"
+#include "FaultInject.h"
+#include "SampleFormat.h"
+#include "Gain.h"
+#include "Codec.h"
 #include "Logging.h"
 #include "TaskPriorities.h"
 
@@ -28,75 +36,189 @@
 
 #include "FreeRTOS.h"
 #include "task.h"
-#include "stream_buffer.h"
-#include "queue.h"
 
-/* These are somewhat arbitrary, but work. Adjust if necessary */
-#define NUM_QUEUE_ITEMS 5
-#define I2S_BUFF_SIZE 1024
+/* Set by the latency profile in AudioConfig.h. The USB side reads straight
+ * out of these buffers, so the pool also covers what used to sit in the
+ * stream buffer. Buffers hold a fixed duration rather than a fixed number of
+ * frames, so latency is the same at every sample rate. Durations are multiples
+ * of 125us, which is a whole number of frames at every (whole kHz) rate */
+#ifndef I2S_NUM_BUFFERS
+#define I2S_NUM_BUFFERS AUDIO_NUM_BUFFERS
+#endif
+#if I2S_NUM_BUFFERS < 4
+#error "I2S_NUM_BUFFERS must be at least 4, two for the DMA and two to prime the USB side"
+#endif
+/* Priming waits for 1.5x the USB side's smallest fill target, which has to fit
+ * in the buffers ready at once (all but the two the DMA holds) or the stream
+ * never starts. Full speed's 1ms packets are capped to fit at run time instead */
+#if ((AUDIO_USB_MIN_FILL_PACKETS * AUDIO_USB_INTERVAL_UFRAMES * 125 * 3) / 2) > \
+    ((I2S_NUM_BUFFERS - 2) * AUDIO_BUFF_US)
+#error "AUDIO_USB_MIN_FILL_PACKETS at this AUDIO_USB_INTERVAL_UFRAMES needs more I2S_NUM_BUFFERS"
+#endif
+#define I2S_BUFF_US AUDIO_BUFF_US
+#define I2S_BUFF_FRAMES(rate) ((((rate) / 1000) * I2S_BUFF_US) / 1000)
+#define I2S_BUFF_SIZE_MAX (I2S_BUFF_FRAMES(AUDIO_MAX_SAMPLE_RATE) * AUDIO_NUM_CHANNELS)
 
-/* Represents a DMA I2S Data buffer transaction */
+/* DMA sample container, parameterized by sample width */
+#if AUDIO_DMA_BYTES_PER_SAMPLE == 4
+typedef int32_t i2s_sample_t;
+#else
+typedef int16_t i2s_sample_t;
+#endif
+
+/* Represents a DMA I2S Data buffer transaction. Channels are interleaved, so
+ * buffers always hold whole frames */
 typedef struct {
-    uint16_t data[I2S_BUFF_SIZE];
-    //Optional room to do other stuff in this struct
+    i2s_sample_t data[I2S_BUFF_SIZE_MAX]; // Only dmaSamples are used
+    uint32_t seq; // DMA completion number, consecutive unless audio was lost
+    uint32_t startFrame; // Capture frame number of the first frame
+#if AUDIO_MEASURE_LATENCY
+    uint32_t doneCycles; // Cycle count when the DMA finished filling it
+#endif
 } i2s_buffer_t;
 
-static StreamBufferHandle_t dataStreamBuff;
 static TaskHandle_t taskHandle;
-static QueueHandle_t emptyQueue;
-static QueueHandle_t fullQueue;
 
 static mxc_i2s_req_t i2s_req; /**< I2S Request instance */
 static int rxChannelID = -1; /**< DMA Channel for Rx */
 static uint32_t dummybuffer; /**< Needed for I2S init */
 
-static i2s_buffer_t bufferPool[NUM_QUEUE_ITEMS];
-static i2s_buffer_t *volatile activeBuffer;
-static i2s_buffer_t *volatile reloadBuffer;
+/* Capture ring. The DMA fills the slots in order, the task prepares them in
+ * order and the USB side sends and releases them in order, so three free
+ * running counts describe the whole ring:
+ *   ringFilled   - completed by the DMA (DMA ISR)
+ *   ringReady    - prepared and handed to the USB side (I2S task)
+ *   ringReleased - sent, or dropped, and free again (USB task, or the I2S
+ *                  task while the stream is off)
+ * The DMA only moves on to a slot that has been released. If there is none it
+ * fills the discard buffer instead, so nothing handed over is ever written
+ * under the reader, and the skipped sequence number tells the consumer audio
+ * was lost. A slot is its count masked to the ring size. The counts wrap at
+ * 2^32, and only a power of two size keeps that on the right slot across the
+ * wrap */
+#define I2S_RING_MASK (I2S_NUM_BUFFERS - 1)
+_Static_assert((I2S_NUM_BUFFERS & I2S_RING_MASK) == 0, "I2S_NUM_BUFFERS must be a power of two");
+static i2s_buffer_t bufferPool[I2S_NUM_BUFFERS];
+static i2s_buffer_t discardBuffer;
+static volatile uint32_t ringFilled;
+static volatile uint32_t ringReady;
+static volatile uint32_t ringReleased;
+
+/* DMA ISR state. The DMA is writing dmaActive and moves to dmaReload next */
+static i2s_buffer_t *dmaActive;
+static i2s_buffer_t *dmaReload;
+static uint32_t dmaSeq; /**< Completions since the DMA was started */
+static uint32_t captureFrames; /**< Frames captured since boot */
+
+/* Buffer sizing for the current sample rate. dmaSamples is what the DMA is
+ * running with, usbBytes what the USB side sees per buffer. usbBytes is
+ * smaller than the DMA bytes when samples are packed */
+static uint32_t dmaSamples;
+static uint32_t usbBytes;
+
+/* Volume/mute, applied in place before the buffer is handed over */
+static gain_t gain;
+
+#if AUDIO_TEST_PATTERN
+#if AUDIO_DMA_BYTES_PER_SAMPLE == 4
+#define I2S_PATTERN_SAMPLE(n) ((i2s_sample_t)((n) << 8))
+#else
+#define I2S_PATTERN_SAMPLE(n) ((i2s_sample_t)(n))
+#endif
+#endif
+
+/* Sample rate the host asked for, applied by the task. 0 if none pending */
+static volatile uint32_t pendingRate;
+
+/* Consumer (USB) side state. The buffer being sent stays in its ring slot
+ * until its last byte is out. Only touched from the USB task, or the I2S task
+ * while flushing. The scheduler is cooperative so the two never interleave */
+static uint32_t consumeOffset; /**< Bytes of the oldest ready buffer sent */
 
 static bool streamRunning = false;
 
 static void I2S_TaskBody(void *param);
 static void I2S_Init(void);
+static void I2S_StartDMA(void);
+static void I2S_Restart(uint32_t sampleRate);
 static void I2S_DMA_Callback(int ch, int error);
-static void I2S_Reload(uint16_t *reloadBuffer, uint32_t bufferSizeSamples);
+static void I2S_Reload(i2s_sample_t *reloadBuffer, uint32_t bufferSizeSamples);
+static void I2S_FormatBuffer(i2s_buffer_t *buff);
+static void I2S_FlushReady(void);
+static i2s_buffer_t *I2S_NextReload(void);
+#if AUDIO_TEST_PATTERN
+static void I2S_FillPattern(i2s_buffer_t *buff);
+#endif
 
-void I2S_TaskInit(StreamBufferHandle_t audioStreamBuff)
+void I2S_TaskInit(void)
 {
-    int i;
-    i2s_buffer_t *bufferPtr;
+    GainInit(&gain);
+    dmaSamples = I2S_BUFF_FRAMES(AUDIO_SAMPLE_RATE) * AUDIO_NUM_CHANNELS;
+    usbBytes = I2S_BUFF_FRAMES(AUDIO_SAMPLE_RATE) * AUDIO_FRAME_BYTES;
 
-    emptyQueue = xQueueCreate(NUM_QUEUE_ITEMS, sizeof(i2s_buffer_t *));
-    fullQueue = xQueueCreate(NUM_QUEUE_ITEMS, sizeof(i2s_buffer_t *));
-
-    //Prime the empty queue
-    for (i = 0; i < NUM_QUEUE_ITEMS; i++) {
-        bufferPtr = &bufferPool[i];
-        xQueueSend(emptyQueue, &bufferPtr, 0);
-    }
-    dataStreamBuff = audioStreamBuff;
-
-    I2S_Init();
+#if AUDIO_MEASURE_LATENCY
+    CycleCounterInit();
+#endif
+    //The DMA ISR notifies the task, so it has to exist first
     xTaskCreate(I2S_TaskBody, "I2S", 512, NULL, TASK_PRIO_I2S, &taskHandle);
+    I2S_Init();
 }
 
 void I2S_TaskBody(void *param)
 {
     i2s_buffer_t *qData;
     bool lastState = false;
+    uint32_t rate;
+    uint32_t nextSeq = 0;
     while (1) {
-        if (xQueueReceive(fullQueue, &qData, portMAX_DELAY) == pdTRUE) {
-            //Simple on/off logic. If on, load into the stream buffer. if
-            //transitioning to on, flush to give a clean slate
+        //The DMA ISR gives one notification per filled buffer, and they may
+        //pile up. The indices cover everything it has published, so work from
+        //those and just use the count to sleep
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (ringReady != __atomic_load_n(&ringFilled, __ATOMIC_ACQUIRE)) {
+            //A rate change invalidates everything captured so far
+            if (pendingRate != 0) {
+                //Clear first, the restart blocks on the codec and the host may
+                //ask for yet another rate meanwhile
+                rate = pendingRate;
+                pendingRate = 0;
+                I2S_Restart(rate);
+                nextSeq = 0;
+                break;
+            }
+            qData = &bufferPool[ringReady & I2S_RING_MASK];
+
+            //Buffers the DMA had to discard show up as a jump in sequence
+            if (qData->seq != nextSeq) {
+                AudioStatsCount(AUDIO_STAT_SEQ_GAP);
+            }
+            nextSeq = qData->seq + 1;
+
+            //Simple on/off logic. If on, hand the buffer itself to the USB
+            //side, it comes back through I2S_TaskConsume once sent. On any
+            //transition, flush to give a clean slate
+            if (streamRunning != lastState) {
+                I2S_FlushReady();
+                lastState = streamRunning;
+            }
+            if (FAULT_HIT(FAULT_I2S_STALL)) {
+                AudioStatsCount(AUDIO_STAT_FAULT_STALL);
+                vTaskDelay(pdMS_TO_TICKS(1 + FaultInjectRandom() % FAULT_I2S_STALL_MAX_MS));
+            }
             if (streamRunning) {
-                if (lastState == false) {
-                    xStreamBufferReset(dataStreamBuff);
-                    lastState = streamRunning;
-                }
-                xStreamBufferSend(dataStreamBuff, qData->data, I2S_BUFF_SIZE * sizeof(uint16_t),
-                                  portMAX_DELAY);
+                BENCH_START();
+#if AUDIO_TEST_PATTERN
+                I2S_FillPattern(qData);
+#endif
+                GainApply(&gain, qData->data, dmaSamples / AUDIO_NUM_CHANNELS);
+                I2S_FormatBuffer(qData);
+                BENCH_END(BENCH_I2S_BUFFER, dmaSamples);
+            }
+            __atomic_store_n(&ringReady, ringReady + 1, __ATOMIC_RELEASE);
+            if (!streamRunning) {
+                //Nobody to send it, straight back to the DMA
+                I2S_FlushReady();
             }
-            xQueueSend(emptyQueue, &qData, portMAX_DELAY);
         }
     }
 }
@@ -108,13 +230,21 @@ void I2S_TaskBody(void *param)
  */
 void I2S_Init()
 {
+#if AUDIO_SAMPLE_BITS == 24
+    //24-in-32, MSB aligned. The codec runs 64 bit clocks per frame
+    i2s_req.wordSize = MXC_I2S_DATASIZE_WORD;
+    i2s_req.sampleSize = MXC_I2S_SAMPLESIZE_TWENTYFOUR;
+    i2s_req.bitsWord = 32;
+    i2s_req.adjust = MXC_I2S_ADJUST_LEFT;
+#else
     i2s_req.wordSize = MXC_I2S_DATASIZE_HALFWORD;
     i2s_req.sampleSize = MXC_I2S_SAMPLESIZE_SIXTEEN;
     i2s_req.bitsWord = 16;
+#endif
     i2s_req.justify = MXC_I2S_MSB_JUSTIFY;
     i2s_req.wsPolarity = MXC_I2S_POL_NORMAL;
     i2s_req.channelMode = MXC_I2S_EXTERNAL_SCK_EXTERNAL_WS;
-    i2s_req.stereoMode = MXC_I2S_MONO_LEFT_CH;
+    i2s_req.stereoMode = (AUDIO_NUM_CHANNELS == 2) ? MXC_I2S_STEREO : MXC_I2S_MONO_LEFT_CH;
     i2s_req.bitOrder = MXC_I2S_MSB_FIRST;
 
     i2s_req.rawData = NULL;
@@ -127,18 +257,54 @@ void I2S_Init()
 
     MXC_I2S_RegisterDMACallback(I2S_DMA_Callback);
 
-    //Grab the first 2 buffers
-    if ((xQueueReceive(emptyQueue, (void *)&activeBuffer, 0) != pdTRUE) ||
-        (xQueueReceive(emptyQueue, (void *)&reloadBuffer, 0) != pdTRUE)) {
-        LOG_MSG_ERR0(I2S, "Fatal Error. No initial I2S buffers");
-        return;
-    }
+    I2S_StartDMA();
+}
+
+/**
+ * Starts the DMA on the first two slots of an empty ring, at the current buffer
+ * size
+ */
+void I2S_StartDMA()
+{
+    ringFilled = 0;
+    ringReady = 0;
+    ringReleased = 0;
+    dmaSeq = 0;
+    dmaActive = &bufferPool[0];
+    dmaReload = &bufferPool[1];
 
     //Start transferring
-    rxChannelID = MXC_I2S_RXDMAConfig((void *)activeBuffer->data, I2S_BUFF_SIZE * sizeof(uint16_t));
+    rxChannelID = MXC_I2S_RXDMAConfig((void *)dmaActive->data, dmaSamples * sizeof(i2s_sample_t));
 
     //And do the first reload
-    I2S_Reload(reloadBuffer->data, I2S_BUFF_SIZE);
+    I2S_Reload(dmaReload->data, dmaSamples);
+}
+
+/**
+ * Stops the DMA, empties the ring, moves the codec to the new rate and
+ * starts capturing again with buffers sized for it. The USB side has already
+ * let go of its buffers in I2S_TaskSetSampleRate.
+ * @param sampleRate - New sample rate in Hz
+ */
+void I2S_Restart(uint32_t sampleRate)
+{
+    //Once the channel is released the callback can't fire, so the ring is
+    //safe to reset afterwards
+    MXC_I2S_RXDisable();
+    MXC_DMA_Stop(rxChannelID);
+    MXC_DMA_ReleaseChannel(rxChannelID);
+    rxChannelID = -1;
+    MXC_I2S_Flush();
+
+    //Notifications already given just cost the task an empty pass
+    consumeOffset = 0;
+
+    CodecSetSampleRate(sampleRate);
+    dmaSamples = I2S_BUFF_FRAMES(sampleRate) * AUDIO_NUM_CHANNELS;
+
+    I2S_StartDMA();
+    LOG_MSG_INFO(I2S, "Restarted at %u Hz, %u samples per buffer", (unsigned)sampleRate,
+                 (unsigned)dmaSamples);
 }
 
 /**
@@ -146,55 +312,217 @@ void I2S_Init()
  * @param reloadBuffer - Sample buffer to set
  * @param bufferSizeSample - Number of _samples_ to configure
  */
-void I2S_Reload(uint16_t *reloadBuffer, uint32_t bufferSizeSamples)
+void I2S_Reload(i2s_sample_t *reloadBuffer, uint32_t bufferSizeSamples)
 {
     mxc_dma_srcdst_t srcdst;
     srcdst.ch = rxChannelID;
     srcdst.dest = (void *)reloadBuffer;
-    srcdst.len = bufferSizeSamples * sizeof(uint16_t);
+    srcdst.len = bufferSizeSamples * sizeof(i2s_sample_t);
     MXC_DMA_SetSrcReload(srcdst);
 }
 
+/**
+ * Converts a filled buffer to the USB subslot format, in place so the buffer
+ * can still be handed over without a copy. 16 bit samples and 24-in-32 samples
+ * in 4 byte subslots are already in wire format.
+ */
+void I2S_FormatBuffer(i2s_buffer_t *buff)
+{
+#if (AUDIO_SAMPLE_BITS == 24) && (AUDIO_BYTES_PER_SAMPLE == 3)
+    SamplePack24(buff->data, buff->data, dmaSamples);
+#else
+    (void)buff;
+#endif
+}
+
 /**
  * Callback from DMA notifying the I2S data is loaded up. The strategy here is
- * to minimize how much work is done in the ISR. So push the buffer to the
- * full queue for processing by the task, and setup the reload. Thats it.
+ * to minimize how much work is done in the ISR. Stamp the buffer, publish it
+ * by bumping the fill count, give the task a notification and point the reload
+ * at the next free slot. No queues, nothing copied. Thats it.
  */
 void I2S_DMA_Callback(int ch, int error)
 {
-    BaseType_t higherTaskWoken;
-    i2s_buffer_t *nextBuff;
-    i2s_buffer_t *tempBuff;
+    BaseType_t higherTaskWoken = pdFALSE;
+    i2s_buffer_t *done;
+    BENCH_START();
     if (ch == rxChannelID) {
-        if (xQueueReceiveFromISR(emptyQueue, &nextBuff, &higherTaskWoken) == pdTRUE) {
-            //Play musical buffer pointers
-            tempBuff = activeBuffer;
-            activeBuffer = reloadBuffer;
-            reloadBuffer = nextBuff;
-            I2S_Reload(reloadBuffer->data, I2S_BUFF_SIZE);
-
-            //TODO(BrentK-ADI): check for failures
-            xQueueSendFromISR(fullQueue, &tempBuff, &higherTaskWoken);
-        } else {
-            //Buffer underflow. No empty buffers available. Reuse the current
-            if (activeBuffer != reloadBuffer) {
-                //If active and reload aren't the same, can push on the queue.
-                //TODO(BrentK-ADI): Check for failures.
-                xQueueSendFromISR(fullQueue, (void *)&activeBuffer, &higherTaskWoken);
-            }
-            //Active and reload buffers are the same
-            activeBuffer = reloadBuffer;
-
-            //Keep pushing the reload until we're no longer underflowing
-            I2S_Reload(reloadBuffer->data, I2S_BUFF_SIZE);
+        AudioStatsCount(AUDIO_STAT_DMA_DONE);
+        if (FAULT_HIT(FAULT_DMA_DELAY)) {
+            AudioStatsCount(AUDIO_STAT_FAULT_DELAY);
+            FaultInjectSpin(FAULT_DMA_DELAY_MAX_US);
+        }
+        done = dmaActive;
+        if (done != &discardBuffer) {
+            done->seq = dmaSeq;
+            done->startFrame = captureFrames;
+#if AUDIO_MEASURE_LATENCY
+            done->doneCycles = CycleCounterGet();
+#endif
+            __atomic_store_n(&ringFilled, ringFilled + 1, __ATOMIC_RELEASE);
+            vTaskNotifyGiveFromISR(taskHandle, &higherTaskWoken);
         }
+        //A discarded buffer still uses up its sequence number, so the task
+        //sees the jump
+        dmaSeq++;
+        captureFrames += dmaSamples / AUDIO_NUM_CHANNELS;
+
+        //The DMA has already moved on to the reload buffer
+        dmaActive = dmaReload;
+        dmaReload = I2S_NextReload();
+        I2S_Reload(dmaReload->data, dmaSamples);
+        BENCH_END(BENCH_DMA_ISR, dmaSamples);
     } else {
         //Error, unexpected
     }
 }
 
+/**
+ * Picks the buffer the DMA fills after dmaActive: the next ring slot if the
+ * USB side has released it, otherwise the discard buffer. Nothing handed over
+ * is ever overwritten. DMA ISR only
+ * @returns Buffer for the next reload
+ */
+i2s_buffer_t *I2S_NextReload()
+{
+    uint32_t next = ringFilled + ((dmaActive != &discardBuffer) ? 1 : 0);
+    uint32_t released = __atomic_load_n(&ringReleased, __ATOMIC_ACQUIRE);
+    bool injected = FAULT_HIT(FAULT_DMA_OVERRUN);
+
+    if (injected || ((next - released) >= I2S_NUM_BUFFERS)) {
+        //Ring full, so the next buffer's audio is lost. Counted rather than
+        //logged, to keep the ISR short; the background task reports it. An
+        //injected overrun acts as if the ring were full
+        AudioStatsCount(AUDIO_STAT_DMA_OVERRUN);
+        if (injected) {
+            AudioStatsCount(AUDIO_STAT_FAULT_OVERRUN);
+        }
+        return &discardBuffer;
+    }
+    return &bufferPool[next & I2S_RING_MASK];
+}
+
+#if AUDIO_TEST_PATTERN
+/**
+ * Overwrites a captured buffer with the test pattern, numbered from the frame
+ * the DMA stamped it with
+ */
+void I2S_FillPattern(i2s_buffer_t *buff)
+{
+    i2s_sample_t *sample = buff->data;
+    uint32_t frame = buff->startFrame;
+    uint32_t i;
+
+    for (i = 0; i < dmaSamples / AUDIO_NUM_CHANNELS; i++, frame++) {
+        sample[0] = I2S_PATTERN_SAMPLE(frame);
+#if AUDIO_NUM_CHANNELS == 2
+        sample[1] = I2S_PATTERN_SAMPLE(~frame);
+#endif
+        sample += AUDIO_NUM_CHANNELS;
+    }
+}
+#endif
+
+/**
+ * Releases every buffer held by the USB side back to the DMA
+ */
+void I2S_FlushReady()
+{
+    __atomic_store_n(&ringReleased, ringReady, __ATOMIC_RELEASE);
+    consumeOffset = 0;
+}
+
+/**
+ * Gets the oldest buffer handed to the USB side. USB task only
+ * @returns The buffer, NULL if none
+ */
+static inline i2s_buffer_t *I2S_OldestReady(void)
+{
+    uint32_t released = ringReleased;
+
+    if (__atomic_load_n(&ringReady, __ATOMIC_ACQUIRE) == released) {
+        return NULL;
+    }
+    return &bufferPool[released & I2S_RING_MASK];
+}
+
+void I2S_TaskSetSampleRate(uint32_t sampleRate)
+{
+    //Nothing captured at the old rate may reach the USB side. The task holds
+    //off handing over buffers until it has restarted the DMA
+    pendingRate = sampleRate;
+    I2S_FlushReady();
+    usbBytes = I2S_BUFF_FRAMES(sampleRate) * AUDIO_FRAME_BYTES;
+}
+
+void I2S_TaskSetGain(uint32_t channel, int16_t q15)
+{
+    GainSetTarget(&gain, channel, q15);
+}
+
+uint32_t I2S_TaskBufferBytes()
+{
+    return usbBytes;
+}
+
+uint32_t I2S_TaskCapacityBytes()
+{
+    //The DMA always holds two buffers
+    return (I2S_NUM_BUFFERS - 2) * usbBytes;
+}
+
+uint32_t I2S_TaskBytesAvailable()
+{
+    uint32_t count = __atomic_load_n(&ringReady, __ATOMIC_ACQUIRE) - ringReleased;
+
+    return (count == 0) ? 0 : ((count * usbBytes) - consumeOffset);
+}
+
+uint32_t I2S_TaskPeek(const uint8_t **data)
+{
+    i2s_buffer_t *buff = I2S_OldestReady();
+
+    if (buff == NULL) {
+        return 0;
+    }
+    *data = (const uint8_t *)buff->data + consumeOffset;
+    return usbBytes - consumeOffset;
+}
+
+void I2S_TaskConsume(uint32_t len)
+{
+    if (I2S_OldestReady() == NULL) {
+        return;
+    }
+    consumeOffset += len;
+    if (consumeOffset >= usbBytes) {
+        //Last byte is out, the DMA can have it back
+        __atomic_store_n(&ringReleased, ringReleased + 1, __ATOMIC_RELEASE);
+        consumeOffset = 0;
+    }
+}
+
+#if AUDIO_MEASURE_LATENCY
+uint32_t I2S_TaskOldestAgeUs()
+{
+    i2s_buffer_t *buff = I2S_OldestReady();
+    uint32_t sinceDone;
+    uint32_t beforeDone;
+
+    if (buff == NULL) {
+        return 0;
+    }
+    //The next byte out was captured before the buffer completed by the share
+    //of the buffer still to send. Buffers are I2S_BUFF_US long at every rate
+    sinceDone = CycleCounterToUs(CycleCounterGet() - buff->doneCycles);
+    beforeDone = (uint32_t)(((uint64_t)(usbBytes - consumeOffset) * I2S_BUFF_US) / usbBytes);
+    return sinceDone + beforeDone;
+}
+#endif
+
 void I2S_TaskStartStream()
 {
+    AudioStatsStartSession();
     streamRunning = true;
 }
 
@@ -18,24 +18,89 @@
 #ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_I2S_TASK_H_
 #define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_I2S_TASK_H_
 
-#include "FreeRTOS.h"
-#include "stream_buffer.h"
+#include <stdint.h>
+
+/** Replace the captured audio with a counting test pattern, for checking the
+ * path from the DMA to the USB wire with tools/checkstream.py. Each frame
+ * carries its capture frame number (16 or 24 bits, wrapping) on the first
+ * channel and its complement on the second. The count advances on every DMA
+ * completion, so buffers lost to an overrun show up as a jump */
+#ifndef AUDIO_TEST_PATTERN
+#define AUDIO_TEST_PATTERN 0
+#endif
 
 /**
  * Initializes the I2S task and immediately starts the I2S DMA. Data will not be
- * pushed to the stream buffer until I2S_TaskStartStream is called
- * @param audioStreamBuf - Streambuffer to push audio data to
+ * handed to the USB side until I2S_TaskStartStream is called
  */
-void I2S_TaskInit(StreamBufferHandle_t audioStreamBuf);
+void I2S_TaskInit(void);
 
 /**
- * Enables the task to push data to the stream buffer
+ * Enables the task to hand filled DMA buffers to the USB side
  */
 void I2S_TaskStartStream(void);
 
 /**
- * Stops the task from pushing data to the stream buffer
+ * Stops the task from handing buffers to the USB side, and reclaims any it
+ * still holds
  */
 void I2S_TaskStopStream(void);
 
+/**
+ * Switches capture to a new sample rate. Anything already captured is dropped,
+ * and the task reprograms the codec and restarts the DMA with buffers resized
+ * to keep the same latency. Call from task context.
+ * @param sampleRate - New sample rate in Hz, one of AUDIO_SAMPLE_RATES
+ */
+void I2S_TaskSetSampleRate(uint32_t sampleRate);
+
+/**
+ * Sets the gain for a channel. Changes are ramped in over a few milliseconds.
+ * @param channel - Zero based channel index
+ * @param q15 - Gain, GAIN_MUTE to GAIN_UNITY
+ */
+void I2S_TaskSetGain(uint32_t channel, int16_t q15);
+
+/**
+ * Gets the size of a single DMA buffer. Data is handed over in units of this
+ * @returns Buffer size in bytes
+ */
+uint32_t I2S_TaskBufferBytes(void);
+
+/**
+ * Gets the most captured data that can be waiting at once. Buffers completing
+ * past this are overrun
+ * @returns Capacity in bytes
+ */
+uint32_t I2S_TaskCapacityBytes(void);
+
+/**
+ * Gets the number of captured bytes waiting to be sent over USB
+ * @returns Number of bytes available
+ */
+uint32_t I2S_TaskBytesAvailable(void);
+
+/**
+ * Gets a pointer directly into the oldest DMA buffer holding unsent data. No
+ * data is copied, the pointer stays valid until the bytes are released with
+ * I2S_TaskConsume.
+ * @param data - Set to the first unsent byte
+ * @returns Number of contiguous bytes available at data, 0 if none
+ */
+uint32_t I2S_TaskPeek(const uint8_t **data);
+
+/**
+ * Marks bytes returned by I2S_TaskPeek as sent. Once the last byte of a DMA
+ * buffer has been consumed, the buffer is returned to the DMA.
+ * @param len - Number of bytes sent. Must not exceed what I2S_TaskPeek returned
+ */
+void I2S_TaskConsume(uint32_t len);
+
+/**
+ * Gets how long ago the next byte I2S_TaskPeek will return was captured. Only
+ * built with AUDIO_MEASURE_LATENCY
+ * @returns Age in microseconds, 0 if nothing is buffered
+ */
+uint32_t I2S_TaskOldestAgeUs(void);
+
 #endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_I2S_TASK_H_
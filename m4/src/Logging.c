@@ -17,64 +17,120 @@
  ******************************************************************************/
 #include <stdio.h>
 #include <stdarg.h>
+#include <string.h>
 
 #include "Logging.h"
 
 #include "TaskPriorities.h"
 #include "FreeRTOS.h"
 #include "task.h"
-#include "queue.h"
+#include "semphr.h"
 
 #include "mxc_device.h"
 #include "mxc_errors.h"
 #include "uart.h"
 
 
-/** Define the number of buffers for strings and their size.  Tune these based
- * on need and memory requirements */
-#ifndef LOGGING_CONSOLE_NUM_BUFFS
-#define LOGGING_CONSOLE_NUM_BUFFS 50
+/** Size of the record ring in bytes. Records are packed, so it holds as many
+ * short lines as fit rather than a fixed count. Must be a power of 2 */
+#ifndef LOGGING_RING_SIZE
+#define LOGGING_RING_SIZE 4096
 #endif
 
-#ifndef LOGGING_CONSOLE_BUF_SIZE
-#define LOGGING_CONSOLE_BUF_SIZE 256
+/** Longest formatted line. Lines are formatted on the caller's stack, so keep
+ * this modest. Anything longer is cut short and ends in LOGGING_TRUNC_MARK */
+#ifndef LOGGING_MAX_LINE
+#define LOGGING_MAX_LINE 256
 #endif
+#define LOGGING_TRUNC_MARK "...\n"
+
+/** Size of the DMA staging buffer. Queued messages are merged into it, so one
+ * transfer usually carries several lines */
+#ifndef LOGGING_DMA_BUF_SIZE
+#define LOGGING_DMA_BUF_SIZE 512
+#endif
+
+/** Console baud rate. soc_init.c brings the UART up at 115200, anything else
+ * is applied in LoggingInit. The UART runs from the 7.3728MHz IBRO, so rates
+ * up to 921600 divide evenly */
+#ifndef LOGGING_UART_BAUD
+#define LOGGING_UART_BAUD 115200
+#endif
+
+/** Upper bound on one transfer, a full staging buffer at 115200 is ~45ms */
+#define LOGGING_DMA_TIMEOUT_MS 1000
+
+#if (LOGGING_RING_SIZE & (LOGGING_RING_SIZE - 1)) != 0
+#error "LOGGING_RING_SIZE must be a power of 2"
+#endif
+#if LOGGING_MAX_LINE > LOGGING_DMA_BUF_SIZE
+#error "LOGGING_MAX_LINE must fit in the DMA staging buffer"
+#endif
+#define LOGGING_RING_MASK (LOGGING_RING_SIZE - 1)
+
+/* Each record is a 32 bit header followed by its payload, padded to a word.
+ * The header holds the payload length in the low 16 bits and the record type
+ * above. Free ring space is kept zeroed, so a header that has not been
+ * written yet reads as REC_NONE */
+#define REC_NONE 0
+#define REC_MSG 1 /**< Payload is text (or a binary record) to send */
+#define REC_PAD 2 /**< Skip to the start of the ring, length is the bytes skipped */
+#define REC_HDR_BYTES 4
+#define REC_BYTES(len) (REC_HDR_BYTES + (((len) + 3u) & ~3u))
+#define REC_HEADER(type, len) (((uint32_t)(type) << 16) | (uint32_t)(len))
 
 /* List of the current levels */
 static log_level_t sourceLevels[LOG_SOURCE_COUNT];
 
-/** Define the memory buffer for console data */
-static char logBuffers[LOGGING_CONSOLE_NUM_BUFFS * LOGGING_CONSOLE_BUF_SIZE];
+/** Record ring. Words, so headers are aligned for atomic access */
+static uint32_t logRing[LOGGING_RING_SIZE / 4];
 
 static mxc_uart_regs_t *loggingUart = MXC_UART_GET_UART(LOGGING_UART);
 
 static TaskHandle_t taskHandle; /**< Console task handle              */
-static QueueHandle_t buffEmptyQ; /**< Queue for empty buffers          */
-static QueueHandle_t buffFullQ; /**< Queue for waiting to be printed  */
+static SemaphoreHandle_t txDoneSem; /**< Given when a DMA transfer ends */
+
+/* Multi producer, single consumer byte ring. ringHead and ringTail are free
+ * running byte counts. Producers (tasks or ISRs) claim space at head with a
+ * compare and swap, fill it, then publish the header. The logging task takes
+ * records from tail in order, stopping at one still being filled. Lock-free,
+ * though not wait-free: a claim retries if an ISR takes the space first. No
+ * critical sections, so an ISR can log at any time through LoggingPuts or
+ * LoggingBinary */
+static volatile uint32_t ringHead; /**< Next byte to claim */
+static volatile uint32_t ringTail; /**< Next record to print */
+
+/* Records lost to a full ring, per source, since the last report */
+static volatile uint32_t dropCounts[LOG_SOURCE_COUNT];
+
+/** Merged messages on their way out. Only touched by the logging task and the
+ * DMA */
+static char dmaBuffer[LOGGING_DMA_BUF_SIZE];
+static mxc_uart_req_t uartReq;
 
 /** Prototypes **/
 static void LoggingTaskBody(void *pvParameters);
+static void LoggingUART_Callback(mxc_uart_req_t *req, int result);
+static uint8_t *LoggingReserve(log_source_t src, uint32_t len);
+static void LoggingCommit(uint8_t *payload, uint32_t len);
 
 int LoggingInit()
 {
     BaseType_t xReturned;
     int i;
-    char *bufPtr;
 
     //Set all the sources to the configured level to start
     for (i = 0; i < LOG_SOURCE_COUNT; i++) {
         sourceLevels[i] = GLOBAL_LOG_LEVEL;
     }
 
-    //Create the queues
-    buffEmptyQ = xQueueCreate(LOGGING_CONSOLE_NUM_BUFFS, sizeof(char *));
-    buffFullQ = xQueueCreate(LOGGING_CONSOLE_NUM_BUFFS, sizeof(char *));
-
-    //Fill the empty queue with all the buffer pointers
-    for (i = 0; i < LOGGING_CONSOLE_NUM_BUFFS; i++) {
-        bufPtr = &(logBuffers[i * LOGGING_CONSOLE_BUF_SIZE]);
-        xQueueSend(buffEmptyQ, &bufPtr, 0);
+    if (LOGGING_UART_BAUD != 115200) {
+        MXC_UART_SetFrequency(loggingUart, LOGGING_UART_BAUD, MXC_UART_IBRO_CLK);
     }
+    //Let the driver claim a DMA channel and handle its completion
+    MXC_UART_SetAutoDMAHandlers(loggingUart, true);
+
+    txDoneSem = xSemaphoreCreateBinary();
 
     //Create the task
     xReturned = xTaskCreate(LoggingTaskBody, (const char *)"Logging", configMINIMAL_STACK_SIZE,
@@ -88,45 +144,231 @@ int LoggingInit()
 }
 
 /**
- *  Actual console task body. Just loop, blocking waiting for messages to display
+ *  Actual console task body. Wait for a message, then merge it and whatever
+ *  else is ready behind it into the staging buffer and hand the lot to the
+ *  DMA. The task sleeps until the transfer is done, so printing costs a copy
+ *  per message rather than CPU time per character.
  */
 void LoggingTaskBody(void *pvParameters)
 {
     int keepRunning = 1;
-    char *bufPtr;
-    char *wrPtr;
+    uint8_t *ringBytes = (uint8_t *)logRing;
+    uint32_t header;
+    uint32_t tail;
+    uint32_t pos;
+    uint32_t len;
+    uint32_t step;
+    size_t used;
     while (keepRunning) {
-        xQueueReceive(buffFullQ, &bufPtr, portMAX_DELAY);
-        wrPtr = bufPtr;
-        /* In theory the console task is a low priority so sitting and blocking
-        on this is fine. TODO in the future, use DMA or interrupt
-        */
-        while (*wrPtr != '\0') {
-            MXC_UART_WriteCharacter(loggingUart, *wrPtr++);
+        used = 0;
+        tail = ringTail;
+        for (;;) {
+            pos = tail & LOGGING_RING_MASK;
+            header = __atomic_load_n(&logRing[pos / 4], __ATOMIC_ACQUIRE);
+            len = header & 0xFFFF;
+            if ((header >> 16) == REC_PAD) {
+                step = len;
+            } else if ((header >> 16) == REC_MSG) {
+                if ((used + len) > LOGGING_DMA_BUF_SIZE) {
+                    break; //Goes in the next transfer
+                }
+                memcpy(&dmaBuffer[used], &ringBytes[pos + REC_HDR_BYTES], len);
+                used += len;
+                step = REC_BYTES(len);
+            } else {
+                break; //Empty, or still being written
+            }
+
+            //Free space must read as REC_NONE, so clear it before moving tail
+            memset(&ringBytes[pos], 0, step);
+            tail += step;
+            __atomic_store_n(&ringTail, tail, __ATOMIC_RELEASE);
+        }
+
+        if (used == 0) {
+            //Nothing ready. Every commit notifies, so nothing is missed
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+        uartReq.uart = loggingUart;
+        uartReq.txData = (const uint8_t *)dmaBuffer;
+        uartReq.txLen = used;
+        uartReq.rxData = NULL;
+        uartReq.rxLen = 0;
+        uartReq.callback = LoggingUART_Callback;
+
+        xSemaphoreTake(txDoneSem, 0);
+        if (MXC_UART_TransactionDMA(&uartReq) == E_NO_ERROR) {
+            //If this times out the text is lost, but the console keeps going
+            xSemaphoreTake(txDoneSem, pdMS_TO_TICKS(LOGGING_DMA_TIMEOUT_MS));
         }
-        xQueueSend(buffEmptyQ, &bufPtr, portMAX_DELAY);
     }
 }
 
-int LoggingPrint(const char *fmt, ...)
+/**
+ * DMA completion, from interrupt context
+ */
+void LoggingUART_Callback(mxc_uart_req_t *req, int result)
+{
+    BaseType_t higherTaskWoken = pdFALSE;
+
+    xSemaphoreGiveFromISR(txDoneSem, &higherTaskWoken);
+}
+
+/**
+ * Claims space for a record. Safe from any context, and never blocks: if
+ * the ring is full the record is counted as dropped instead. A record never
+ * wraps, when it would not fit before the end of the ring the rest of the ring
+ * is claimed along with it and skipped with a pad record
+ * @param src - Source of the record, for drop accounting
+ * @param len - Payload length in bytes
+ * @returns Where to write the payload, or NULL if the ring is full
+ */
+uint8_t *LoggingReserve(log_source_t src, uint32_t len)
+{
+    uint32_t head = __atomic_load_n(&ringHead, __ATOMIC_RELAXED);
+    uint32_t pos;
+    uint32_t pad;
+    uint32_t total;
+
+    do {
+        pos = head & LOGGING_RING_MASK;
+        pad = 0;
+        if ((pos + REC_BYTES(len)) > LOGGING_RING_SIZE) {
+            pad = LOGGING_RING_SIZE - pos;
+        }
+        total = pad + REC_BYTES(len);
+        if ((head + total - __atomic_load_n(&ringTail, __ATOMIC_ACQUIRE)) > LOGGING_RING_SIZE) {
+            if (src < LOG_SOURCE_COUNT) {
+                __atomic_fetch_add(&dropCounts[src], 1, __ATOMIC_RELAXED);
+            }
+            return NULL;
+        }
+        //Only retries if another producer (an ISR) claimed the space first
+    } while (!__atomic_compare_exchange_n(&ringHead, &head, head + total, true, __ATOMIC_ACQUIRE,
+                                          __ATOMIC_RELAXED));
+
+    if (pad != 0) {
+        __atomic_store_n(&logRing[pos / 4], REC_HEADER(REC_PAD, pad), __ATOMIC_RELEASE);
+        pos = 0;
+    }
+    return (uint8_t *)&logRing[pos / 4] + REC_HDR_BYTES;
+}
+
+/**
+ * Publishes a filled record to the logging task
+ * @param payload - Pointer returned by LoggingReserve
+ * @param len - Payload length, as reserved
+ */
+void LoggingCommit(uint8_t *payload, uint32_t len)
+{
+    BaseType_t higherTaskWoken = pdFALSE;
+    uint32_t *header = (uint32_t *)(payload - REC_HDR_BYTES);
+
+    __atomic_store_n(header, REC_HEADER(REC_MSG, len), __ATOMIC_RELEASE);
+    if (taskHandle == NULL) {
+        return;
+    }
+    if (xPortIsInsideInterrupt()) {
+        vTaskNotifyGiveFromISR(taskHandle, &higherTaskWoken);
+    } else {
+        xTaskNotifyGive(taskHandle);
+    }
+}
+
+int LoggingPrint(log_source_t src, const char *fmt, ...)
 {
     va_list args;
 
     va_start(args, fmt);
-    LoggingvPrint(fmt, args);
+    LoggingvPrint(src, fmt, args);
     va_end(args);
     return 0;
 }
 
-void LoggingvPrint(const char *fmt, va_list args)
+void LoggingvPrint(log_source_t src, const char *fmt, va_list args)
 {
-    char *bufPtr;
-    BaseType_t xReturned;
+    char line[LOGGING_MAX_LINE];
+    uint8_t *payload;
+    int len;
 
-    xReturned = xQueueReceive(buffEmptyQ, &bufPtr, 0);
-    if (xReturned == pdPASS) {
-        vsnprintf(bufPtr, LOGGING_CONSOLE_BUF_SIZE, fmt, args);
-        xQueueSend(buffFullQ, &bufPtr, 0);
+    //Format first, so the record takes only the bytes the line needs
+    len = vsnprintf(line, sizeof(line), fmt, args);
+    if (len <= 0) {
+        return;
+    }
+    if (len >= (int)sizeof(line)) {
+        //Mark the cut, and keep the line break so the next line starts clean
+        len = sizeof(line) - 1;
+        memcpy(&line[len - (sizeof(LOGGING_TRUNC_MARK) - 1)], LOGGING_TRUNC_MARK,
+               sizeof(LOGGING_TRUNC_MARK) - 1);
+    }
+    if ((payload = LoggingReserve(src, (uint32_t)len)) != NULL) {
+        memcpy(payload, line, (size_t)len);
+        LoggingCommit(payload, (uint32_t)len);
+    }
+}
+
+int LoggingPuts(log_source_t src, const char *str)
+{
+    uint8_t *payload;
+    size_t len = strnlen(str, LOGGING_MAX_LINE - 1);
+
+    if ((len != 0) && ((payload = LoggingReserve(src, (uint32_t)len)) != NULL)) {
+        memcpy(payload, str, len);
+        LoggingCommit(payload, (uint32_t)len);
+    }
+    return 0;
+}
+
+void LoggingBinary(log_source_t src, uint32_t nargs, const char *fmt, ...)
+{
+    va_list args;
+    uint8_t *payload;
+    uint8_t *wrPtr;
+    uint32_t words[2 + LOG_BIN_MAX_ARGS];
+    uint32_t i;
+
+    if (nargs > LOG_BIN_MAX_ARGS) {
+        nargs = LOG_BIN_MAX_ARGS;
+    }
+    if ((payload = LoggingReserve(src, 2 + 4 * (2 + nargs))) == NULL) {
+        return;
+    }
+
+    words[0] = (uint32_t)(uintptr_t)fmt;
+    words[1] = (uint32_t)(xPortIsInsideInterrupt() ? xTaskGetTickCountFromISR() :
+                                                      xTaskGetTickCount());
+    va_start(args, fmt);
+    for (i = 0; i < nargs; i++) {
+        words[2 + i] = va_arg(args, uint32_t);
+    }
+    va_end(args);
+
+    //Byte at a time, little endian, so the record needs no alignment
+    wrPtr = payload;
+    *wrPtr++ = LOG_BIN_SYNC;
+    *wrPtr++ = (uint8_t)(4 * (2 + nargs));
+    for (i = 0; i < 2 + nargs; i++) {
+        *wrPtr++ = (uint8_t)words[i];
+        *wrPtr++ = (uint8_t)(words[i] >> 8);
+        *wrPtr++ = (uint8_t)(words[i] >> 16);
+        *wrPtr++ = (uint8_t)(words[i] >> 24);
+    }
+    LoggingCommit(payload, 2 + 4 * (2 + nargs));
+}
+
+void LoggingReportDrops()
+{
+    uint32_t i;
+    uint32_t count;
+
+    for (i = 0; i < LOG_SOURCE_COUNT; i++) {
+        count = __atomic_exchange_n(&dropCounts[i], 0, __ATOMIC_RELAXED);
+        if (count != 0) {
+            LOG_MSG_WARN(BKGND, "Dropped %u log records from source %u", (unsigned)count,
+                         (unsigned)i);
+        }
     }
 }
 
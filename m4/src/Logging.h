@@ -20,6 +20,7 @@
 #define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_LOGGING_H_
 
 #include <stdarg.h>
+#include <stdint.h>
 #include <stdio.h>
 
 /**
@@ -53,6 +54,20 @@ typedef enum {
 #define GLOBAL_LOG_LEVEL LOG_LEVEL_WARN
 #endif
 
+/* Binary logging. Instead of formatting on the target, each message is sent
+ * as a record holding the format string's flash address, the tick count and
+ * the raw arguments. tools/logdecode.py rebuilds the text from the ELF. Every
+ * argument must be an integer (or pointer) of 32 bits or less.
+ */
+#ifndef LOGGING_BINARY
+#define LOGGING_BINARY 0
+#endif
+
+/* Binary record framing: LOG_BIN_SYNC, payload length, then the payload of
+ * format address, tick count and arguments, all 32 bit little endian */
+#define LOG_BIN_SYNC 0xA5
+#define LOG_BIN_MAX_ARGS 8
+
 /**
  * Initializes the LoggingSystem.  All sources by default get GLOBAL_LOG_LEVEL
  */
@@ -74,23 +89,69 @@ log_level_t LoggingGetSourceLevel(log_source_t src);
 void LoggingSetSourceLevel(log_source_t src, log_level_t level);
 
 /**
- * Performs a print to the logging console based on format and args.
+ * Performs a print to the logging console based on format and args. Tasks
+ * only, formatting is too heavy for an ISR; use the '0' macros (LoggingPuts)
+ * there, or build with LOGGING_BINARY. If the log is full the record is
+ * dropped and counted. Lines longer than LOGGING_MAX_LINE (256) are cut short
+ * and end in "...".
+ * @param src - Source logging, for drop accounting
  * @param fmt - Format string
  * @param ... - Variable arguments
  */
-int LoggingPrint(const char *fmt, ...);
+int LoggingPrint(log_source_t src, const char *fmt, ...);
 
 /**
  * Performs a print to the logging console using va_list arguments
+ * @param src - Source logging, for drop accounting
  * @param fmt - Format string
  * @param args - Argument list
  */
-void LoggingvPrint(const char *fmt, va_list args);
+void LoggingvPrint(log_source_t src, const char *fmt, va_list args);
+
+/**
+ * Queues a string as is, without formatting. Safe from tasks and ISRs.
+ * @param src - Source logging, for drop accounting
+ * @param str - String to log
+ */
+int LoggingPuts(log_source_t src, const char *str);
+
+/**
+ * Queues a binary log record. Nothing is formatted, fmt is only recorded by
+ * address. Use through LOG_MSG_OUTPUT. Safe from tasks and ISRs.
+ * @param src - Source logging, for drop accounting
+ * @param nargs - Number of arguments after fmt, at most LOG_BIN_MAX_ARGS
+ * @param fmt - Format string, must be a literal in flash
+ * @param ... - 32 bit integer arguments
+ */
+void LoggingBinary(log_source_t src, uint32_t nargs, const char *fmt, ...);
+
+/**
+ * Logs, and clears, the number of records each source has lost to a full log
+ * since the last call. Call periodically from a task.
+ */
+void LoggingReportDrops(void);
+
+/* Counts the arguments after the format string, by the size of an array of
+ * them. sizeof doesn't evaluate them, and the count is a compile time constant
+ * with no upper limit, so LOG_NARGS_CHECKED can reject a record that has more
+ * than LOG_BIN_MAX_ARGS instead of silently dropping the extra ones */
+#define LOG_NARGS(_f, ...) ((sizeof((uint32_t[]){ 0, __VA_ARGS__ }) / sizeof(uint32_t)) - 1)
+#define LOG_NARGS_CHECKED(...)                                                                 \
+    (LOG_NARGS(__VA_ARGS__) + 0 * sizeof(struct {                                              \
+         _Static_assert(LOG_NARGS(__VA_ARGS__) <= LOG_BIN_MAX_ARGS, "Too many log arguments"); \
+         int unused;                                                                           \
+     }))
 
 /** Were the logged output should go.  This should have the same argument
- *  setup as printf  (fmt, ...)
+ *  setup as printf, with the source in front  (src, fmt, ...)
  */
+#if LOGGING_BINARY
+#define LOG_MSG_OUTPUT(src, ...) LoggingBinary(src, LOG_NARGS_CHECKED(__VA_ARGS__), __VA_ARGS__)
+#define LOG_MSG_OUTPUT0(src, str) LoggingBinary(src, 0, str)
+#else
 #define LOG_MSG_OUTPUT LoggingPrint
+#define LOG_MSG_OUTPUT0 LoggingPuts
+#endif
 
 /*****
  * The following Macros should be used for logging.  This allows compile time
@@ -100,7 +161,7 @@ void LoggingvPrint(const char *fmt, va_list args);
 #if GLOBAL_LOG_LEVEL >= LOG_LEVEL_ERR
 #define LOG_MSG_ERR(src, msg, ...)                   \
     if (LoggingGetSourceLevel(src) >= LOG_LEVEL_ERR) \
-    LOG_MSG_OUTPUT("ERR:[" #src "]:" msg "\n", __VA_ARGS__)
+    LOG_MSG_OUTPUT(src, "ERR:[" #src "]:" msg "\n", __VA_ARGS__)
 #else
 #define LOG_MSG_ERR(src, msg, ...)
 #endif
@@ -108,7 +169,7 @@ void LoggingvPrint(const char *fmt, va_list args);
 #if GLOBAL_LOG_LEVEL >= LOG_LEVEL_WARN
 #define LOG_MSG_WARN(src, msg, ...)                   \
     if (LoggingGetSourceLevel(src) >= LOG_LEVEL_WARN) \
-    LOG_MSG_OUTPUT("WARN:[" #src "]:" msg "\n", __VA_ARGS__)
+    LOG_MSG_OUTPUT(src, "WARN:[" #src "]:" msg "\n", __VA_ARGS__)
 #else
 #define LOG_MSG_WARN(src, msg, ...)
 #endif
@@ -116,7 +177,7 @@ void LoggingvPrint(const char *fmt, va_list args);
 #if GLOBAL_LOG_LEVEL >= LOG_LEVEL_INFO
 #define LOG_MSG_INFO(src, msg, ...)                   \
     if (LoggingGetSourceLevel(src) >= LOG_LEVEL_INFO) \
-    LOG_MSG_OUTPUT("INFO:[" #src "]:" msg "\n", __VA_ARGS__)
+    LOG_MSG_OUTPUT(src, "INFO:[" #src "]:" msg "\n", __VA_ARGS__)
 #else
 #define LOG_MSG_INFO(src, msg, ...)
 #endif
@@ -124,19 +185,20 @@ void LoggingvPrint(const char *fmt, va_list args);
 #if GLOBAL_LOG_LEVEL >= LOG_LEVEL_DEBUG
 #define LOG_MSG_DBG(src, msg, ...)                     \
     if (LoggingGetSourceLevel(src) >= LOG_LEVEL_DEBUG) \
-    LOG_MSG_OUTPUT("DBG:[" #src "]:" msg "\n", __VA_ARGS__)
+    LOG_MSG_OUTPUT(src, "DBG:[" #src "]:" msg "\n", __VA_ARGS__)
 #else
 #define LOG_MSG_DBG(src, msg, ...)
 #endif
 
 /* Same MACROs as above but '0' versions which have no values passed to the
    printf call.  C99 (and others) wont allow __VA_ARGS__ to be empty, this
-   is a solution to that
+   is a solution to that. Nothing is formatted, so these are the ones to use
+   from an ISR
  */
 #if GLOBAL_LOG_LEVEL >= LOG_LEVEL_ERR
 #define LOG_MSG_ERR0(src, msg)                       \
     if (LoggingGetSourceLevel(src) >= LOG_LEVEL_ERR) \
-    LOG_MSG_OUTPUT("ERR:[" #src "]:" msg "\n")
+    LOG_MSG_OUTPUT0(src, "ERR:[" #src "]:" msg "\n")
 #else
 #define LOG_MSG_ERR0(src, msg)
 #endif
@@ -144,7 +206,7 @@ void LoggingvPrint(const char *fmt, va_list args);
 #if GLOBAL_LOG_LEVEL >= LOG_LEVEL_WARN
 #define LOG_MSG_WARN0(src, msg)                       \
     if (LoggingGetSourceLevel(src) >= LOG_LEVEL_WARN) \
-    LOG_MSG_OUTPUT("WARN:[" #src "]:" msg "\n")
+    LOG_MSG_OUTPUT0(src, "WARN:[" #src "]:" msg "\n")
 #else
 #define LOG_MSG_WARN0(src, msg)
 #endif
@@ -152,7 +214,7 @@ void LoggingvPrint(const char *fmt, va_list args);
 #if GLOBAL_LOG_LEVEL >= LOG_LEVEL_INFO
 #define LOG_MSG_INFO0(src, msg)                       \
     if (LoggingGetSourceLevel(src) >= LOG_LEVEL_INFO) \
-    LOG_MSG_OUTPUT("INFO:[" #src "]:" msg "\n")
+    LOG_MSG_OUTPUT0(src, "INFO:[" #src "]:" msg "\n")
 #else
 #define LOG_MSG_INFO0(src, msg)
 #endif
@@ -160,7 +222,7 @@ void LoggingvPrint(const char *fmt, va_list args);
 #if GLOBAL_LOG_LEVEL >= LOG_LEVEL_DEBUG
 #define LOG_MSG_DBG0(src, msg)                         \
     if (LoggingGetSourceLevel(src) >= LOG_LEVEL_DEBUG) \
-    LOG_MSG_OUTPUT("DBG:[" #src "]:" msg "\n")
+    LOG_MSG_OUTPUT0(src, "DBG:[" #src "]:" msg "\n")
 #else
 #define LOG_MSG_DBG0(src, msg)
 #endif
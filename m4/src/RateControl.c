@@ -0,0 +1,104 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#include "RateControl.h"
+
+/* Gains are scaled to the packet rate so the loop behaves the same at full
+ * and high speed, and to the fill target so a small target isn't drained by
+ * drift before the loop reacts:
+ *  - Proportional gain pulls a fill error back in ~4 seconds, or sooner when
+ *    the target is small: 2000ppm of drift is held with one target of error,
+ *    so a real crystal's error costs well under half of it
+ *  - Fill filter time constant is a quarter of that, ~1 second at most, so
+ *    it removes the DMA buffer sawtooth without lagging the loop
+ *  - Integral gain is (Kp/2)^2, critically damping the loop
+ */
+#define RATE_CTRL_KP_MAX_SEC 4
+#define RATE_CTRL_KP_HOLD_PPM 2000
+
+/* Largest drift the integrator can hold. Real crystals are well inside this,
+ * so anything more is the fill error from priming, an underflow or a stall,
+ * and left unbounded it would take minutes to unwind once the fill recovers */
+#define RATE_CTRL_MAX_DRIFT_PPM 1000
+
+void RateControlInit(rate_ctrl_t *rc, uint32_t sampleRate, uint32_t packetsPerSec,
+                     uint32_t targetFrames)
+{
+    //Packets for the proportional time constant, then the shift that gets there
+    uint64_t kpPackets = (uint64_t)packetsPerSec * RATE_CTRL_KP_MAX_SEC;
+    uint64_t holdPackets = ((uint64_t)targetFrames * packetsPerSec * 1000000) /
+                           ((uint64_t)sampleRate * RATE_CTRL_KP_HOLD_PPM);
+    uint8_t kp = 2;
+
+    if (holdPackets < kpPackets) {
+        kpPackets = holdPackets;
+    }
+    while ((1ULL << kp) < kpPackets) {
+        kp++;
+    }
+
+    rc->nominal = (uint32_t)(((uint64_t)sampleRate << 16) / packetsPerSec);
+    rc->minFrames = rc->nominal >> 16;
+    if (rc->minFrames > 0) {
+        rc->minFrames--;
+    }
+    rc->maxFrames = ((rc->nominal + 0xFFFF) >> 16) + 1;
+    rc->target = (int32_t)(targetFrames << 16);
+    rc->fillAvg = rc->target;
+    rc->integ = 0;
+    rc->phase = 0;
+    rc->filtShift = kp - 2;
+    rc->kpShift = kp;
+    rc->kiShift = 2 * kp + 2;
+    rc->integMax = (((int64_t)rc->nominal * RATE_CTRL_MAX_DRIFT_PPM) / 1000000) << rc->kiShift;
+}
+
+uint32_t RateControlNextPacket(rate_ctrl_t *rc, uint32_t fillFrames)
+{
+    int32_t err;
+    int32_t rate;
+    uint32_t frames;
+
+    rc->fillAvg += ((int32_t)(fillFrames << 16) - rc->fillAvg) >> rc->filtShift;
+    err = rc->fillAvg - rc->target;
+    rc->integ += err;
+    if (rc->integ > rc->integMax) {
+        rc->integ = rc->integMax;
+    } else if (rc->integ < -rc->integMax) {
+        rc->integ = -rc->integMax;
+    }
+
+    rate = (int32_t)rc->nominal + (int32_t)(rc->integ >> rc->kiShift) + (err >> rc->kpShift);
+    if (rate < (int32_t)(rc->minFrames << 16)) {
+        rate = (int32_t)(rc->minFrames << 16);
+    } else if (rate > (int32_t)(rc->maxFrames << 16)) {
+        rate = (int32_t)(rc->maxFrames << 16);
+    }
+
+    //Carry the fractional part so the long term average is exact
+    rc->phase += (uint32_t)rate;
+    frames = rc->phase >> 16;
+    rc->phase &= 0xFFFF;
+    return frames;
+}
+
+int32_t RateControlDriftPpm(const rate_ctrl_t *rc)
+{
+    int64_t drift = rc->integ >> rc->kiShift;
+
+    return (int32_t)((drift * 1000000) / (int64_t)rc->nominal);
+}
@@ -0,0 +1,80 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_RATECONTROL_H_
+#define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_RATECONTROL_H_
+
+#include <stdint.h>
+
+/**
+ * Packet size controller for an asynchronous UAC2 source. The codec clock and
+ * the USB SOF clock are independent, so the number of frames sent per packet
+ * is varied between N-1, N and N+1 to keep the amount of buffered audio near
+ * a target.
+ *
+ * The controller is called once per packet, which is once per SOF (service
+ * interval), so the packet count is the SOF time base. A slow filter on the
+ * buffered fill level removes the DMA buffer sawtooth, and a PI loop on that
+ * filtered level tracks the clock drift. The integrator holds the drift
+ * estimate, so the fill level settles back on target rather than just being
+ * held in bounds. It is clamped to +/-1000ppm so a long fill error (priming,
+ * a stall) can't wind it up past any real clock difference.
+ *
+ * All values are Q16.16 frames unless noted.
+ */
+typedef struct {
+    uint32_t nominal; /**< Nominal frames per packet                */
+    uint32_t minFrames; /**< Smallest packet, whole frames            */
+    uint32_t maxFrames; /**< Largest packet, whole frames             */
+    int32_t target; /**< Target fill level                        */
+    int32_t fillAvg; /**< Filtered fill level                      */
+    int64_t integ; /**< Integrated fill error (drift estimate)   */
+    int64_t integMax; /**< Integrator limit, anti-windup            */
+    uint32_t phase; /**< Fractional frames carried between packets */
+    uint8_t filtShift; /**< Fill filter time constant, as a shift    */
+    uint8_t kpShift; /**< Proportional gain, as a shift            */
+    uint8_t kiShift; /**< Integral gain, as a shift                */
+} rate_ctrl_t;
+
+/**
+ * Initializes the controller for a stream
+ * @param rc - Controller instance
+ * @param sampleRate - Nominal sample rate in Hz
+ * @param packetsPerSec - Packets per second (1000 FS, 8000 / microframes per
+ *                        interval HS)
+ * @param targetFrames - Fill level to hold, in whole frames
+ */
+void RateControlInit(rate_ctrl_t *rc, uint32_t sampleRate, uint32_t packetsPerSec,
+                     uint32_t targetFrames);
+
+/**
+ * Runs the controller for one packet
+ * @param rc - Controller instance
+ * @param fillFrames - Frames currently buffered, before this packet is taken
+ * @returns Number of whole frames to send in this packet
+ */
+uint32_t RateControlNextPacket(rate_ctrl_t *rc, uint32_t fillFrames);
+
+/**
+ * Gets the current clock drift estimate. Positive means the codec clock is
+ * running faster than the USB clock.
+ * @param rc - Controller instance
+ * @returns Drift in parts per million
+ */
+int32_t RateControlDriftPpm(const rate_ctrl_t *rc);
+
+#endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_RATECONTROL_H_
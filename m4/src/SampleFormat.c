@@ -0,0 +1,93 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#include "SampleFormat.h"
+
+#if defined(__ARM_FEATURE_DSP)
+#include "cmsis_compiler.h"
+#define PACK_HALVES(lo, hi, shift) __PKHBT(lo, hi, shift)
+#else
+/* Portable reference for the halfword pack, bit exact with PKHBT */
+#define PACK_HALVES(lo, hi, shift) (((lo)&0x0000FFFFUL) | (((hi) << (shift)) & 0xFFFF0000UL))
+#endif
+
+/* Both kernels work on groups of 4 samples (3 words packed), which is a whole
+ * number of words on each side. Word loads and stores with barrel shifted ORs
+ * are single cycle on the M4, so there is no byte shuffling at all. Any
+ * trailing samples fall back to bytes.
+ */
+
+void SamplePack24(void *dst, const int32_t *src, uint32_t count)
+{
+    uint32_t *out = (uint32_t *)dst;
+    const uint32_t *in = (const uint32_t *)src;
+    uint8_t *outBytes;
+    uint32_t s0, s1, s2, s3;
+    uint32_t i;
+
+    for (i = count / 4; i > 0; i--) {
+        //Read the whole group before writing, in place the first store
+        //lands on top of s0
+        s0 = in[0];
+        s1 = in[1];
+        s2 = in[2];
+        s3 = in[3];
+        in += 4;
+
+        out[0] = (s0 >> 8) | ((s1 & 0x0000FF00UL) << 16);
+        out[1] = PACK_HALVES(s1 >> 16, s2, 8);
+        out[2] = (s2 >> 24) | (s3 & 0xFFFFFF00UL);
+        out += 3;
+    }
+
+    outBytes = (uint8_t *)out;
+    for (i = count & 3; i > 0; i--) {
+        s0 = *in++;
+        *outBytes++ = (uint8_t)(s0 >> 8);
+        *outBytes++ = (uint8_t)(s0 >> 16);
+        *outBytes++ = (uint8_t)(s0 >> 24);
+    }
+}
+
+void SampleUnpack24(int32_t *dst, const void *src, uint32_t count)
+{
+    uint32_t *out = (uint32_t *)dst;
+    const uint32_t *in = (const uint32_t *)src;
+    const uint8_t *inBytes;
+    uint32_t w0, w1, w2;
+    uint32_t i;
+
+    for (i = count / 4; i > 0; i--) {
+        w0 = in[0];
+        w1 = in[1];
+        w2 = in[2];
+        in += 3;
+
+        out[0] = w0 << 8;
+        out[1] = PACK_HALVES((w0 >> 16) & 0x0000FF00UL, w1, 16);
+        out[2] = ((w1 >> 8) & 0x00FFFF00UL) | (w2 << 24);
+        out[3] = w2 & 0xFFFFFF00UL;
+        out += 4;
+    }
+
+    inBytes = (const uint8_t *)in;
+    for (i = count & 3; i > 0; i--) {
+        *out++ = ((uint32_t)inBytes[0] << 8) | ((uint32_t)inBytes[1] << 16) |
+                 ((uint32_t)inBytes[2] << 24);
+        inBytes += 3;
+    }
+}
@@ -0,0 +1,42 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2025 Analog Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_SAMPLEFORMAT_H_
+#define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_SAMPLEFORMAT_H_
+
+#include <stdint.h>
+
+/**
+ * Packs MSB aligned 24-in-32 samples into 3 byte little endian UAC2 subslots.
+ * Works in place: dst may be the same buffer as src, as the packed data never
+ * overtakes the samples still to be read.
+ * @param dst - Destination, count * 3 bytes. 4 byte aligned
+ * @param src - Source samples, 24 bit value in bits 31:8
+ * @param count - Number of samples
+ */
+void SamplePack24(void *dst, const int32_t *src, uint32_t count);
+
+/**
+ * Unpacks 3 byte little endian subslots back to MSB aligned 24-in-32 samples,
+ * the inverse of SamplePack24. Not in place.
+ * @param dst - Destination samples, 24 bit value in bits 31:8
+ * @param src - Source subslots, count * 3 bytes. 4 byte aligned
+ * @param count - Number of samples
+ */
+void SampleUnpack24(int32_t *dst, const void *src, uint32_t count);
+
+#endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_SAMPLEFORMAT_H_
@@ -24,6 +24,7 @@
 
 #define TASK_PRIO_BACKGROUND (tskIDLE_PRIORITY + 1)
 #define TASK_PRIO_LOGGING (TASK_PRIO_BACKGROUND + 1)
+#define TASK_PRIO_CODEC TASK_PRIO_BACKGROUND // Control changes only, never urgent
 #define TASK_PRIO_I2S (TASK_PRIO_LOGGING + 1)
 #define TASK_PRIO_USBD (TASK_PRIO_I2S + 1)
 
@@ -17,6 +17,12 @@
  ******************************************************************************/
 #include "USB_Task.h"
 #include "I2S_Task.h"
+#include "RateControl.h"
+#include "AudioStats.h"
+#include "Benchmark.h"
+#include "FaultInject.h"
+#include "Gain.h"
+#include "Codec.h"
 #include "TaskPriorities.h"
 #include "Logging.h"
 
@@ -30,42 +36,54 @@
 
 #include "FreeRTOS.h"
 #include "task.h"
-#include "stream_buffer.h"
 
 #define USBD_STACK_SIZE (4 * configMINIMAL_STACK_SIZE / 2) * (CFG_TUSB_DEBUG ? 2 : 1)
-#define TX_BLOCK_SIZE (CFG_TUD_AUDIO_EP_SZ_IN - 2)
+#define TX_FRAME_BYTES AUDIO_FRAME_BYTES
 
-static StreamBufferHandle_t dataStreamBuff;
 static TaskHandle_t taskHandle;
 
-// Used to transition from streambuff to USB. Kept off the stack
-static uint8_t txBuffer[TX_BLOCK_SIZE];
+// Sent while the I2S side has not caught up yet
+static const uint8_t silence[CFG_TUD_AUDIO_EP_SZ_IN];
+
+// Packet sizing for the asynchronous IN endpoint
+static rate_ctrl_t rateCtrl;
+static uint32_t fillTarget; // Frames
+static bool primed;
 
 // Range states
-static audio_control_range_4_n_t(1) sampleFreqRng; // Sample freq
+static audio_control_range_4_n_t(AUDIO_NUM_SAMPLE_RATES) sampleFreqRng; // Sample freq
+static const uint32_t sampleRates[AUDIO_NUM_SAMPLE_RATES] = AUDIO_SAMPLE_RATES;
 
 // Audio controls
-// Current states. Not used yet, information only
+// Current states. Master and channel settings combine into one gain per
+// channel, split between the codec and the I2S gain stage
 static bool mute[CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_TX + 1]; // +1 for master channel 0
-static uint16_t volume[CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_TX + 1]; // +1 for master channel 0
+static int16_t volume[CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_TX + 1]; // +1 for master channel 0, 1/256 dB
 static uint32_t sampFreq;
 static uint8_t clkValid;
 
 static void USB_TaskBody(void *param);
+static void USB_StartRateControl(void);
+static bool USB_SetSampleRate(uint32_t rate);
+static void USB_UpdateGain(void);
 
-void USB_TaskInit(StreamBufferHandle_t audioStreamBuff)
+void USB_TaskInit(void)
 {
-    dataStreamBuff = audioStreamBuff;
+    int i;
 
     board_init();
 
-    //Setup the control structures.
+    //Setup the control structures. Start at the codec's power up gain
+    volume[0] = CODEC_GAIN_DEFAULT_DB * 256;
     sampFreq = CFG_TUD_AUDIO_FUNC_1_SAMPLE_RATE;
     clkValid = 1;
-    sampleFreqRng.wNumSubRanges = 1;
-    sampleFreqRng.subrange[0].bMin = CFG_TUD_AUDIO_FUNC_1_SAMPLE_RATE;
-    sampleFreqRng.subrange[0].bMax = CFG_TUD_AUDIO_FUNC_1_SAMPLE_RATE;
-    sampleFreqRng.subrange[0].bRes = 0;
+    sampleFreqRng.wNumSubRanges = AUDIO_NUM_SAMPLE_RATES;
+    for (i = 0; i < AUDIO_NUM_SAMPLE_RATES; i++) {
+        sampleFreqRng.subrange[i].bMin = sampleRates[i];
+        sampleFreqRng.subrange[i].bMax = sampleRates[i];
+        sampleFreqRng.subrange[i].bRes = 0;
+    }
+    USB_StartRateControl();
 
     xTaskCreate(USB_TaskBody, "USBD", USBD_STACK_SIZE, NULL, TASK_PRIO_USBD, &taskHandle);
 }
@@ -83,24 +101,143 @@ void USB_TaskBody(void *param)
     }
 }
 
+/**
+ * Resets packet sizing for a new stream. The target is one DMA buffer of fill,
+ * which leaves roughly half a buffer of margin at the bottom of the sawtooth
+ * as DMA buffers arrive, and at least AUDIO_USB_MIN_FILL_PACKETS packets.
+ * Priming waits for 1.5x the target, so the target is capped to keep that a
+ * buffer or a packet, whichever is longer, short of what the ring can hold.
+ * The ring keeps filling until the next poll, and 1ms full speed packets on
+ * the 125us profile would otherwise overrun it straight after priming.
+ */
+void USB_StartRateControl()
+{
+    uint32_t packetsPerSec =
+        (tud_speed_get() == TUSB_SPEED_HIGH) ? (8000 / AUDIO_USB_INTERVAL_UFRAMES) : 1000;
+    uint32_t packetBytes = ((sampFreq / packetsPerSec) + 1) * TX_FRAME_BYTES;
+    uint32_t headroom =
+        (packetBytes > I2S_TaskBufferBytes()) ? packetBytes : I2S_TaskBufferBytes();
+    uint32_t maxTarget = 0;
+
+    if (I2S_TaskCapacityBytes() > headroom) {
+        maxTarget = (((I2S_TaskCapacityBytes() - headroom) / TX_FRAME_BYTES) * 2) / 3;
+    }
+    fillTarget = I2S_TaskBufferBytes() / TX_FRAME_BYTES;
+    //Small (low latency) buffers still need a few packets of margin
+    if (fillTarget < (AUDIO_USB_MIN_FILL_PACKETS * sampFreq) / packetsPerSec) {
+        fillTarget = (AUDIO_USB_MIN_FILL_PACKETS * sampFreq) / packetsPerSec;
+    }
+    if (fillTarget > maxTarget) {
+        LOG_MSG_WARN(USBD, "Fill target %u frames capped to %u by the ring size",
+                     (unsigned)fillTarget, (unsigned)maxTarget);
+        fillTarget = maxTarget;
+    }
+    RateControlInit(&rateCtrl, sampFreq, packetsPerSec, fillTarget);
+    primed = false;
+}
+
+int32_t USB_TaskDriftPpm()
+{
+    return RateControlDriftPpm(&rateCtrl);
+}
+
+/**
+ * Moves the stream to a new sample rate. The I2S side drops what it has and
+ * restarts at the new rate, and this side primes again from silence.
+ * @param rate - Requested rate in Hz
+ * @returns false if the rate isn't one of the advertised ones
+ */
+bool USB_SetSampleRate(uint32_t rate)
+{
+    int i;
+
+    for (i = 0; i < AUDIO_NUM_SAMPLE_RATES; i++) {
+        if (sampleRates[i] == rate) {
+            break;
+        }
+    }
+    if (i == AUDIO_NUM_SAMPLE_RATES) {
+        LOG_MSG_ERR(USBD, "Unsupported sample rate %u Hz", (unsigned)rate);
+        return false;
+    }
+
+    if (rate != sampFreq) {
+        sampFreq = rate;
+        I2S_TaskSetSampleRate(rate);
+        USB_StartRateControl();
+    }
+    return true;
+}
+
 /**
  * IMPORTANT: This is the callback from the stack that is used to push more
- * data into the USB stack.  This implementation leverages a streambuffer from
- * the I2S Task to shuttle data across. Do a check at the start to see if
- * enough is available, and if not, just send 0s. This strategy gives the I2S
- * time to fill the stream buffer when the USB EP is first opened.
+ * data into the USB stack.  This implementation writes straight out of the I2S
+ * Task's DMA buffers, so the only copy is the one into the endpoint FIFO.
+ *
+ * The endpoint is asynchronous, so each packet carries however many whole
+ * frames the rate controller asks for (N-1, N or N+1) to track the codec clock.
+ * This is called once per service interval (1ms at full speed,
+ * AUDIO_USB_INTERVAL_UFRAMES microframes at high speed), which is the
+ * controller's SOF time base.
+ * Until enough is buffered to start with the fill level averaging the target,
+ * just send 0s. This strategy gives the I2S time to fill buffers when the USB
+ * EP is first opened. An underflow drops back to that state, so a hiccup costs
+ * one gap instead of a run of them.
  */
 bool tud_audio_tx_done_pre_load_cb(uint8_t rhport, uint8_t itf, uint8_t ep_in,
                                    uint8_t cur_alt_setting)
 {
-    BaseType_t higherPriorityTask;
-    if (xStreamBufferBytesAvailable(dataStreamBuff) < TX_BLOCK_SIZE) {
-        //Data underflow. Just 0 out.
-        memset(txBuffer, 0, TX_BLOCK_SIZE);
-    } else {
-        xStreamBufferReceiveFromISR(dataStreamBuff, txBuffer, TX_BLOCK_SIZE, &higherPriorityTask);
+    const uint8_t *data;
+    uint32_t len;
+    uint32_t remaining;
+    uint32_t fill = I2S_TaskBytesAvailable() / TX_FRAME_BYTES;
+    uint32_t frames;
+    BENCH_START();
+
+    //The histogram is scaled by the fill target
+    AudioStatsFill(fill, fillTarget);
+    if (!primed) {
+        if (fill < (fillTarget + fillTarget / 2)) {
+            AudioStatsCount(AUDIO_STAT_USB_PRIME);
+            tud_audio_write(silence, (rateCtrl.nominal >> 16) * TX_FRAME_BYTES);
+            return true;
+        }
+        primed = true;
     }
-    tud_audio_write(txBuffer, TX_BLOCK_SIZE);
+
+    frames = RateControlNextPacket(&rateCtrl, fill);
+    if (FAULT_HIT(FAULT_USB_SKIP)) {
+        //As if the host had missed the packet, nothing is taken
+        AudioStatsCount(AUDIO_STAT_FAULT_USB_SKIP);
+        tud_audio_write(silence, frames * TX_FRAME_BYTES);
+        return true;
+    }
+    if (fill < frames) {
+        //Data underflow. Just 0 out and prime again.
+        AudioStatsCount(AUDIO_STAT_USB_UNDERFLOW);
+        primed = false;
+        tud_audio_write(silence, frames * TX_FRAME_BYTES);
+        return true;
+    }
+    AudioStatsCount(AUDIO_STAT_USB_PACKETS);
+    AudioStatsAdd(AUDIO_STAT_USB_BYTES, frames * TX_FRAME_BYTES);
+#if AUDIO_MEASURE_LATENCY
+    AudioStatsLatency(I2S_TaskOldestAgeUs());
+#endif
+    remaining = frames * TX_FRAME_BYTES;
+
+    //A packet may straddle the end of one DMA buffer and the start of the next
+    while (remaining > 0) {
+        len = I2S_TaskPeek(&data);
+        if (len > remaining) {
+            len = remaining;
+        }
+        tud_audio_write(data, len);
+        I2S_TaskConsume(len);
+        remaining -= len;
+    }
+    //Only packets carrying audio are timed
+    BENCH_END(BENCH_USB_PACKET, frames * AUDIO_NUM_CHANNELS);
     return true;
 }
 
@@ -110,6 +247,7 @@ bool tud_audio_set_itf_cb(uint8_t rhport, tusb_control_request_t const *p_reques
     uint8_t const alt = tu_u16_low(tu_le16toh(p_request->wValue));
     if ((itf == 1) && (alt != 0)) {
         // Audio streaming start
+        USB_StartRateControl();
         I2S_TaskStartStream();
     }
 
@@ -137,8 +275,37 @@ bool tud_audio_set_req_itf_cb(uint8_t rhport, tusb_control_request_t const *p_re
     return false; // Yet not implemented
 }
 
+/**
+ * Pushes the combined master and per channel volume/mute down to the codec and
+ * the I2S gain stage. The codec covers as much of the gain as it can, and the
+ * digital stage only the part below the codec's range, so it stays at unity
+ * (and costs nothing) over the whole hardware range. Mute is digital so it
+ * ramps. Called on every change, which is rare, so all channels are redone.
+ */
+void USB_UpdateGain()
+{
+    uint32_t ch;
+    int32_t vol;
+    int32_t db;
+    int32_t hw;
+
+    for (ch = 1; ch <= CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_TX; ch++) {
+        vol = (int32_t)volume[0] + volume[ch];
+        db = (vol >= 0) ? ((vol + 128) / 256) : -((-vol + 128) / 256);
+        hw = db;
+        if (hw > CODEC_GAIN_MAX_DB) {
+            hw = CODEC_GAIN_MAX_DB;
+        } else if (hw < CODEC_GAIN_MIN_DB) {
+            hw = CODEC_GAIN_MIN_DB;
+        }
+
+        CodecSetInputGain(ch - 1, hw);
+        I2S_TaskSetGain(ch - 1,
+                        (mute[0] || mute[ch]) ? GAIN_MUTE : GainDbToQ15((db - hw) * 256));
+    }
+}
+
 // Invoked when audio class specific set request received for an entity
-// TODO(BrentK-ADI): Have the volume and mute control the CODEC and or I2S processing
 bool tud_audio_set_req_entity_cb(uint8_t rhport, tusb_control_request_t const *p_request,
                                  uint8_t *pBuff)
 {
@@ -153,19 +320,36 @@ bool tud_audio_set_req_entity_cb(uint8_t rhport, tusb_control_request_t const *p
 
     // If request is for our feature unit
     if (entityID == 2) {
+        TU_VERIFY(channelNum <= CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_TX);
         switch (ctrlSel) {
         case AUDIO_FU_CTRL_MUTE:
             mute[channelNum] = ((audio_control_cur_1_t *)pBuff)->bCur;
+            USB_UpdateGain();
             LOG_MSG_INFO(USBD, "Set Mute: %d of channel: %u", mute[channelNum], channelNum);
             return true;
         case AUDIO_FU_CTRL_VOLUME:
-            volume[channelNum] = (uint16_t)((audio_control_cur_2_t *)pBuff)->bCur;
-            LOG_MSG_INFO(USBD, "Set Volume: %d dB of channel: %u", volume[channelNum], channelNum);
+            volume[channelNum] = ((audio_control_cur_2_t *)pBuff)->bCur;
+            USB_UpdateGain();
+            LOG_MSG_INFO(USBD, "Set Volume: %d/256 dB of channel: %u", volume[channelNum],
+                         channelNum);
             return true;
         default: // Unknown/Unsupported control
             return false;
         }
     }
+
+    // Clock Source unit
+    if (entityID == 4) {
+        switch (ctrlSel) {
+        case AUDIO_CS_CTRL_SAM_FREQ:
+            TU_VERIFY(p_request->wLength == sizeof(audio_control_cur_4_t));
+            LOG_MSG_INFO(USBD, "Set Sample Freq: %u",
+                         (unsigned)((audio_control_cur_4_t *)pBuff)->bCur);
+            return USB_SetSampleRate((uint32_t)((audio_control_cur_4_t *)pBuff)->bCur);
+        default: // Unknown/Unsupported control
+            return false;
+        }
+    }
     return false; // Yet not implemented
 }
 
@@ -194,9 +378,9 @@ bool tud_audio_get_req_entity_cb(uint8_t rhport, tusb_control_request_t const *p
     if (entityID == 1) {
         switch (ctrlSel) {
         case AUDIO_TE_CTRL_CONNECTOR:
-            // Those are dummy values for now
-            ret.bNrChannels = 1;
-            ret.bmChannelConfig = (audio_channel_config_t)0;
+            // Cluster matches the AS interface
+            ret.bNrChannels = CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_TX;
+            ret.bmChannelConfig = (audio_channel_config_t)AUDIO_I2S_CHANNEL_CONFIG;
             ret.iChannelNames = 0;
 
             LOG_MSG_INFO0(USBD, "Get terminal connector");
@@ -210,6 +394,7 @@ bool tud_audio_get_req_entity_cb(uint8_t rhport, tusb_control_request_t const *p
 
     // Feature unit
     if (entityID == 2) {
+        TU_VERIFY(channelNum <= CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_TX);
         switch (ctrlSel) {
         case AUDIO_FU_CTRL_MUTE:
             // Audio control mute cur parameter block consists of only one byte - we thus can send it right away
@@ -227,13 +412,13 @@ bool tud_audio_get_req_entity_cb(uint8_t rhport, tusb_control_request_t const *p
             case AUDIO_CS_REQ_RANGE:
                 LOG_MSG_INFO(USBD, "Get Volume range of channel: %u", channelNum);
 
-                // Copy values - only for testing - better is version below
+                // Codec range, extended down by the digital gain table. In 1/256 dB
                 audio_control_range_2_n_t(1) ret;
 
                 ret.wNumSubRanges = 1;
-                ret.subrange[0].bMin = -90; // -90 dB
-                ret.subrange[0].bMax = 90; // +90 dB
-                ret.subrange[0].bRes = 1; // 1 dB steps
+                ret.subrange[0].bMin = (CODEC_GAIN_MIN_DB + GAIN_MIN_DB) * 256;
+                ret.subrange[0].bMax = CODEC_GAIN_MAX_DB * 256;
+                ret.subrange[0].bRes = 256; // 1 dB steps
 
                 return tud_audio_buffer_and_schedule_control_xfer(rhport, p_request, (void *)&ret,
                                                                   sizeof(ret));
@@ -18,14 +18,19 @@
 #ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_USB_TASK_H_
 #define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_USB_TASK_H_
 
-#include "FreeRTOS.h"
-#include "stream_buffer.h"
+#include <stdint.h>
 
 /**
- * Initializes the USB task and the UAC2 device class and handlers
- * @param audioStreamBuf - Streambuffer which will carry the audio data to
- *                         transmit.
+ * Initializes the USB task and the UAC2 device class and handlers. Audio data
+ * is pulled from the I2S task's DMA buffers.
  */
-void USB_TaskInit(StreamBufferHandle_t audioStreamBuf);
+void USB_TaskInit(void);
+
+/**
+ * Gets the rate controller's estimate of the codec clock's drift from the USB
+ * clock, for the stats report. Call from task context
+ * @returns Drift in parts per million, positive when the codec runs fast
+ */
+int32_t USB_TaskDriftPpm(void);
 
 #endif // EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_USB_TASK_H_
@@ -25,30 +25,19 @@
 #include "USB_Task.h"
 #include "I2S_Task.h"
 #include "Logging.h"
+#include "Codec.h"
+#include "AudioStats.h"
+#include "Benchmark.h"
 
 #include "FreeRTOS.h"
 #include "task.h"
-#include "stream_buffer.h"
 
-#include "i2c.h"
-#include "i2c_regs.h"
 #include "dma.h"
 #include "nvic_table.h"
 
-#define CODEC_I2C MXC_I2C2
-#define MAX9867_ADDR 0x18
-
-#define CODEC_MCLOCK 12288000
-#define SAMPLE_RATE 48000
-
-static StreamBufferHandle_t dataSB;
 static TaskHandle_t backgroundTask;
 
 static void BackgroundTaskBody(void *pvParameters);
-static void ConfigureCodec(void);
-static void CodecWriteReg(uint8_t reg, uint8_t val);
-static uint8_t CodecReadReg(uint8_t reg);
-static void CodecUpdateReg(uint8_t reg, uint8_t mask, uint8_t val);
 
 /* Global DMA Handler */
 void DMA_Handler(void)
@@ -78,94 +67,21 @@ int main(void)
 void BackgroundTaskBody(void *pvParameters)
 {
     LoggingInit();
-    dataSB = xStreamBufferCreate(0x4000, 1);
-    ConfigureCodec();
-    USB_TaskInit(dataSB);
-    I2S_TaskInit(dataSB);
+#if AUDIO_BENCHMARK
+    BenchRunKernels();
+#endif
+    CodecInit();
+    //The USB side sizes its fill target from the I2S ring
+    I2S_TaskInit();
+    USB_TaskInit();
 
     while (1) {
         vTaskDelay(5000 / portTICK_PERIOD_MS);
         LOG_MSG_INFO0(BKGND, "Tick");
+        LoggingReportDrops();
+        AudioStatsReport();
+#if AUDIO_BENCHMARK
+        BenchReport();
+#endif
     }
 }
-
-void CodecUpdateReg(uint8_t reg, uint8_t mask, uint8_t val)
-{
-    uint8_t tmp;
-
-    tmp = CodecReadReg(reg);
-    tmp &= ~mask;
-    tmp |= val & mask;
-
-    CodecWriteReg(reg, tmp);
-}
-
-void CodecWriteReg(uint8_t reg, uint8_t val)
-{
-    uint8_t buf[2] = { reg, val };
-    mxc_i2c_req_t i2c_req;
-
-    i2c_req.i2c = CODEC_I2C;
-    i2c_req.addr = MAX9867_ADDR;
-    i2c_req.restart = 0;
-    i2c_req.callback = (void *)0;
-    i2c_req.tx_buf = buf;
-    i2c_req.tx_len = sizeof(buf);
-    i2c_req.rx_len = 0;
-
-    //The I2C driver is buggy and sometimes returns before the bus is ready.
-    //Wait for a ready bus to compensate for that.
-    while (CODEC_I2C->status & MXC_F_I2C_STATUS_MST_BUSY) {}
-    MXC_I2C_MasterTransaction(&i2c_req);
-}
-
-uint8_t CodecReadReg(uint8_t reg)
-{
-    uint8_t buf[1] = { reg };
-    uint8_t dest;
-    mxc_i2c_req_t i2c_req;
-
-    i2c_req.i2c = CODEC_I2C;
-    i2c_req.addr = MAX9867_ADDR;
-    i2c_req.restart = 0;
-    i2c_req.callback = (void *)0;
-    i2c_req.tx_buf = buf;
-    i2c_req.tx_len = sizeof(buf);
-    i2c_req.rx_buf = &dest;
-    i2c_req.rx_len = 1;
-
-    //The I2C driver is buggy and sometimes returns before the bus is ready.
-    //Wait for a ready bus to compensate for that.
-    while (CODEC_I2C->status & MXC_F_I2C_STATUS_MST_BUSY) {}
-    MXC_I2C_MasterTransaction(&i2c_req);
-    return dest;
-}
-
-void ConfigureCodec()
-{
-    uint8_t r;
-
-    CodecWriteReg(0x17, 0x00); //Shutdown for configuration
-
-    for (r = 0x4; r < 0x17; r++) {
-        //Clear all regs to POR
-        CodecWriteReg(0x17, 0x00);
-    }
-
-    CodecWriteReg(0x05, 0x1 << 4); //Prescaler for 12.2MHz clock
-    CodecWriteReg(0x06, 0x60); //NI=0x6000, giving LRCLK 48kHz
-    CodecWriteReg(0x09, 0x02);
-    CodecWriteReg(0x08, 0x98); //I2S format, data is delayed 1 bit clock, HI-Z mode disabled
-    CodecWriteReg(0x14, 0xA0); //Stereo Line In
-    CodecWriteReg(0x15, 0x00);
-    CodecWriteReg(0xA, 0x90); //Audio filters
-    CodecWriteReg(0xD, 0xFF); //ADC Level -12Db
-    CodecWriteReg(0xE, 0x4F); //Line in -6dB, disconnected from headphone
-    CodecWriteReg(0xF, 0x4F); //Line in -6dB, disconnected from headphones
-
-    //Assert SHDN as first step in toggling SHDN when changing enabled circuitry
-    CodecUpdateReg(0x17, 0x80, 0x00);
-
-    //Enable ADCs and Line In
-    CodecUpdateReg(0x17, 0xE3, 0x80 | 0x1 | 0x2 | 0x20 | 0x40);
-}
@@ -27,6 +27,9 @@
 #ifndef EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_TUSB_CONFIG_H_
 #define EXAMPLES_MAX32690_USB_TINYUSB_UAC2_I2S_FREERTOS_TUSB_CONFIG_H_
 
+#include "AudioConfig.h"
+#include "usb_descriptors.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -108,26 +111,51 @@ extern "C" {
 //--------------------------------------------------------------------
 
 // Have a look into audio_device.h for all configurations
-#define CFG_TUD_AUDIO_FUNC_1_SAMPLE_RATE 48000 //MAX9867 Driver defaults to 24khz
+#define CFG_TUD_AUDIO_FUNC_1_SAMPLE_RATE AUDIO_SAMPLE_RATE // Rate at enumeration, host may change it
+#define CFG_TUD_AUDIO_FUNC_1_MAX_SAMPLE_RATE AUDIO_MAX_SAMPLE_RATE
 
-#define CFG_TUD_AUDIO_FUNC_1_DESC_LEN TUD_AUDIO_MIC_ONE_CH_DESC_LEN
+#define CFG_TUD_AUDIO_FUNC_1_DESC_LEN TUD_AUDIO_I2S_MIC_DESC_LEN(AUDIO_NUM_CHANNELS)
 #define CFG_TUD_AUDIO_FUNC_1_N_AS_INT \
     1 // Number of Standard AS Interface Descriptors (4.9.1) defined per audio function - this is required to be able to remember the current alternate settings of these interfaces - We restrict us here to have a constant number for all audio functions (which means this has to be the maximum number of AS interfaces an audio function has and a second audio function with less AS interfaces just wastes a few bytes)
 #define CFG_TUD_AUDIO_FUNC_1_CTRL_BUF_SZ 64 // Size of control request buffer
 
 #define CFG_TUD_AUDIO_ENABLE_EP_IN 1
 #define CFG_TUD_AUDIO_FUNC_1_N_BYTES_PER_SAMPLE_TX \
-    2 // Driver gets this info from the descriptors - we define it here to use it to setup the descriptors and to do calculations with it below
+    AUDIO_BYTES_PER_SAMPLE // Driver gets this info from the descriptors - we define it here to use it to setup the descriptors and to do calculations with it below
 #define CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_TX \
-    1 // Driver gets this info from the descriptors - we define it here to use it to setup the descriptors and to do calculations with it below - be aware: for different number of channels you need another descriptor!
-#define CFG_TUD_AUDIO_EP_SZ_IN                                    \
-    TUD_AUDIO_EP_SIZE(CFG_TUD_AUDIO_FUNC_1_SAMPLE_RATE,           \
-                      CFG_TUD_AUDIO_FUNC_1_N_BYTES_PER_SAMPLE_TX, \
-                      CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_TX)
+    AUDIO_NUM_CHANNELS // Driver gets this info from the descriptors - we define it here to use it to setup the descriptors and to do calculations with it below
+// Full speed packets are 1ms of audio, high speed ones AUDIO_USB_INTERVAL_UFRAMES microframes.
+// Buffers are sized for whichever is larger
+#define CFG_TUD_AUDIO_EP_SZ_IN_FS                                     \
+    TUD_AUDIO_I2S_EP_SIZE(CFG_TUD_AUDIO_FUNC_1_MAX_SAMPLE_RATE,       \
+                          CFG_TUD_AUDIO_FUNC_1_N_BYTES_PER_SAMPLE_TX, \
+                          CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_TX, 1000)
+#define CFG_TUD_AUDIO_EP_SZ_IN_HS                                     \
+    TUD_AUDIO_I2S_EP_SIZE(CFG_TUD_AUDIO_FUNC_1_MAX_SAMPLE_RATE,       \
+                          CFG_TUD_AUDIO_FUNC_1_N_BYTES_PER_SAMPLE_TX, \
+                          CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_TX,         \
+                          8000 / AUDIO_USB_INTERVAL_UFRAMES)
+// One transaction per service interval, the largest isochronous packets each speed allows
+#if CFG_TUD_AUDIO_EP_SZ_IN_FS > 1023
+#error "Stream format needs more than 1023 bytes per full speed frame"
+#endif
+#if CFG_TUD_AUDIO_EP_SZ_IN_HS > 1024
+#error "Stream format needs more than 1024 bytes per high speed service interval"
+#endif
+#define CFG_TUD_AUDIO_EP_SZ_IN                                                              \
+    (TUD_OPT_HIGH_SPEED ? TU_MAX(CFG_TUD_AUDIO_EP_SZ_IN_FS, CFG_TUD_AUDIO_EP_SZ_IN_HS) : \
+                          CFG_TUD_AUDIO_EP_SZ_IN_FS)
 #define CFG_TUD_AUDIO_FUNC_1_EP_IN_SZ_MAX CFG_TUD_AUDIO_EP_SZ_IN
-#define CFG_TUD_AUDIO_FUNC_1_EP_IN_SW_BUF_SZ \
-    (TUD_OPT_HIGH_SPEED ? 8 : 1) *           \
-        CFG_TUD_AUDIO_EP_SZ_IN // Example write FIFO every 1ms, so it should be 8 times larger for HS device
+#if AUDIO_LATENCY_PROFILE == 0
+// Holds 1ms of packets at either speed
+#define CFG_TUD_AUDIO_FUNC_1_EP_IN_SW_BUF_SZ                                                   \
+    (TUD_OPT_HIGH_SPEED ? TU_MAX((8 / AUDIO_USB_INTERVAL_UFRAMES) * CFG_TUD_AUDIO_EP_SZ_IN_HS, \
+                                 CFG_TUD_AUDIO_EP_SZ_IN_FS) :                                  \
+                          CFG_TUD_AUDIO_EP_SZ_IN_FS)
+#else
+// One packet per service interval is written, so one going out and one queued is enough
+#define CFG_TUD_AUDIO_FUNC_1_EP_IN_SW_BUF_SZ (2 * CFG_TUD_AUDIO_EP_SZ_IN)
+#endif
 
 #ifdef __cplusplus
 }
@@ -76,28 +76,52 @@ uint8_t const *tud_descriptor_device_cb(void)
 //--------------------------------------------------------------------+
 enum { ITF_NUM_AUDIO_CONTROL = 0, ITF_NUM_AUDIO_STREAMING, ITF_NUM_TOTAL };
 
-#define CONFIG_TOTAL_LEN (TUD_CONFIG_DESC_LEN + CFG_TUD_AUDIO * TUD_AUDIO_MIC_ONE_CH_DESC_LEN)
+#define CONFIG_TOTAL_LEN (TUD_CONFIG_DESC_LEN + CFG_TUD_AUDIO * CFG_TUD_AUDIO_FUNC_1_DESC_LEN)
 #define EPNUM_AUDIO 0x01
 
-uint8_t const desc_configuration[] = {
+// Full speed sends one packet per 1ms frame
+uint8_t const desc_fs_configuration[] = {
     // Config number, interface count, string index, total length, attribute, power in mA
     TUD_CONFIG_DESCRIPTOR(1, ITF_NUM_TOTAL, 0, CONFIG_TOTAL_LEN, 0x00, 100),
 
-    // Interface number, string index, EP Out & EP In address, EP size
-    TUD_AUDIO_MIC_ONE_CH_DESCRIPTOR(
+    // Interface number, string index, EP Out & EP In address, EP size, interval
+    TUD_AUDIO_I2S_MIC_DESCRIPTOR(
         /*_itfnum*/ ITF_NUM_AUDIO_CONTROL, /*_stridx*/ 0,
+        /*_nch*/ CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_TX, /*_chcfg*/ AUDIO_I2S_CHANNEL_CONFIG,
         /*_nBytesPerSample*/ CFG_TUD_AUDIO_FUNC_1_N_BYTES_PER_SAMPLE_TX,
-        /*_nBitsUsedPerSample*/ CFG_TUD_AUDIO_FUNC_1_N_BYTES_PER_SAMPLE_TX * 8,
-        /*_epin*/ 0x80 | EPNUM_AUDIO, /*_epsize*/ CFG_TUD_AUDIO_EP_SZ_IN)
+        /*_nBitsUsedPerSample*/ AUDIO_SAMPLE_BITS,
+        /*_epin*/ 0x80 | EPNUM_AUDIO, /*_epsize*/ CFG_TUD_AUDIO_EP_SZ_IN_FS, /*_interval*/ 0x01)
 };
 
+#if TUD_OPT_HIGH_SPEED
+// High speed sends one packet per AUDIO_USB_INTERVAL_UFRAMES microframes
+uint8_t const desc_hs_configuration[] = {
+    // Config number, interface count, string index, total length, attribute, power in mA
+    TUD_CONFIG_DESCRIPTOR(1, ITF_NUM_TOTAL, 0, CONFIG_TOTAL_LEN, 0x00, 100),
+
+    // Interface number, string index, EP Out & EP In address, EP size, interval
+    TUD_AUDIO_I2S_MIC_DESCRIPTOR(
+        /*_itfnum*/ ITF_NUM_AUDIO_CONTROL, /*_stridx*/ 0,
+        /*_nch*/ CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_TX, /*_chcfg*/ AUDIO_I2S_CHANNEL_CONFIG,
+        /*_nBytesPerSample*/ CFG_TUD_AUDIO_FUNC_1_N_BYTES_PER_SAMPLE_TX,
+        /*_nBitsUsedPerSample*/ AUDIO_SAMPLE_BITS,
+        /*_epin*/ 0x80 | EPNUM_AUDIO, /*_epsize*/ CFG_TUD_AUDIO_EP_SZ_IN_HS,
+        /*_interval*/ AUDIO_USB_BINTERVAL)
+};
+#endif
+
 // Invoked when received GET CONFIGURATION DESCRIPTOR
 // Application return pointer to descriptor
 // Descriptor contents must exist long enough for transfer to complete
 uint8_t const *tud_descriptor_configuration_cb(uint8_t index)
 {
     (void)index; // for multiple configurations
-    return desc_configuration;
+#if TUD_OPT_HIGH_SPEED
+    // The endpoint interval and size depend on the speed the bus came up at
+    return (tud_speed_get() == TUSB_SPEED_HIGH) ? desc_hs_configuration : desc_fs_configuration;
+#else
+    return desc_fs_configuration;
+#endif
 }
 
 //--------------------------------------------------------------------+
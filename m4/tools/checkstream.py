@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2025 Analog Devices, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+"""Checks a recording of the test pattern (AUDIO_TEST_PATTERN=1) for gaps.
+
+The firmware sends each frame's capture number on the first channel and its
+complement on the second, so a recording of the device is self checking:
+any frame that doesn't follow the one before it was dropped, duplicated or
+zero filled on the way from the DMA to the host.
+
+    arecord -D hw:UAC2 -f S16_LE -c 2 -r 48000 -d 60 capture.wav
+    checkstream.py capture.wav
+
+Exits non-zero if anything but leading silence was found.
+"""
+
+import argparse
+import sys
+import wave
+
+MAX_EVENTS = 20
+
+
+def frames(path):
+    """Yields (first channel, second channel or None) per frame, as the
+    pattern's 16 or 24 bit count. 32 bit samples carry it in bits 31:8"""
+    with wave.open(path, "rb") as wav:
+        width = wav.getsampwidth()
+        channels = wav.getnchannels()
+        data = wav.readframes(wav.getnframes())
+    if width not in (2, 3, 4):
+        sys.exit(f"{path}: unsupported sample width {width}")
+    shift = 8 if width == 4 else 0
+    step = width * channels
+    for pos in range(0, len(data) - step + 1, step):
+        values = [int.from_bytes(data[pos + c * width:pos + (c + 1) * width], "little") >> shift
+                  for c in range(channels)]
+        yield values[0], (values[1] if channels > 1 else None)
+
+
+def check(path, verbose):
+    """Walks the recording, returns the event counts"""
+    with wave.open(path, "rb") as wav:
+        bits = 16 if wav.getsampwidth() == 2 else 24
+    mask = (1 << bits) - 1
+    counts = {"frames": 0, "leading": 0, "zero": 0, "dropped": 0, "duplicated": 0, "corrupt": 0}
+    events = []
+    expected = None
+
+    def event(kind, index, detail):
+        if len(events) < MAX_EVENTS or verbose:
+            events.append(f"frame {index}: {kind} {detail}")
+
+    for index, (first, second) in enumerate(frames(path)):
+        counts["frames"] += 1
+        silent = first == 0 and (second is None or second == 0)
+        if expected is None:
+            # Silence until the stream primes
+            if silent:
+                counts["leading"] += 1
+                continue
+            expected = first
+        if silent and first != expected:
+            counts["zero"] += 1
+            event("zero", index, "")
+            continue
+        if second is not None and second != (~first & mask):
+            counts["corrupt"] += 1
+            event("corrupt", index, f"0x{first:x}/0x{second:x}")
+            expected = (first + 1) & mask
+            continue
+        if first != expected:
+            # Half the counter range either way decides forward or back
+            jump = (first - expected) & mask
+            if jump < (1 << (bits - 1)):
+                counts["dropped"] += jump
+                event("dropped", index, f"{jump} frames")
+            else:
+                counts["duplicated"] += (mask + 1) - jump
+                event("duplicated", index, f"{(mask + 1) - jump} frames")
+        expected = (first + 1) & mask
+    return counts, events
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("wav", help="recording of the device")
+    parser.add_argument("-v", "--verbose", action="store_true", help="list every event")
+    opts = parser.parse_args()
+
+    counts, events = check(opts.wav, opts.verbose)
+    for line in events:
+        print(line)
+    print(", ".join(f"{name} {value}" for name, value in counts.items()))
+    bad = counts["zero"] + counts["dropped"] + counts["duplicated"] + counts["corrupt"]
+    sys.exit(1 if bad else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2025 Analog Devices, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+"""Decodes the binary log (LOGGING_BINARY=1) back to text.
+
+Each record is LOG_BIN_SYNC (0xA5), a payload length, then 32 bit little
+endian words: the format string's address, the tick count and the arguments.
+Format strings are read straight out of the ELF the firmware was built from.
+
+    logdecode.py build/max32690.elf /dev/ttyACM0
+    logdecode.py build/max32690.elf capture.bin
+
+Configure the serial port first, e.g. stty -F /dev/ttyACM0 115200 raw
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+LOG_BIN_SYNC = 0xA5
+LOG_BIN_MAX_ARGS = 8
+
+SHF_ALLOC = 0x2
+SHT_PROGBITS = 1
+
+CONVERSION = re.compile(r"%[-+ #0]*\d*(?:\.\d+)?(?:hh|h|ll|l|z|t)?([diouxXcsp%])")
+
+
+class Elf:
+    """Just enough ELF32 to read strings at their load addresses"""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF" or self.data[4] != 1:
+            raise ValueError(f"{path} is not a 32 bit ELF")
+        shoff, = struct.unpack_from("<I", self.data, 0x20)
+        shentsize, shnum = struct.unpack_from("<HH", self.data, 0x2E)
+        self.sections = []
+        for i in range(shnum):
+            _, stype, flags, addr, offset, size = struct.unpack_from(
+                "<IIIIII", self.data, shoff + i * shentsize)
+            if stype == SHT_PROGBITS and (flags & SHF_ALLOC) and size:
+                self.sections.append((addr, offset, size))
+
+    def string_at(self, addr):
+        for start, offset, size in self.sections:
+            if start <= addr < start + size:
+                begin = offset + addr - start
+                end = self.data.index(b"\0", begin, offset + size)
+                return self.data[begin:end].decode("ascii", "replace")
+        return None
+
+
+def format_record(fmt, args):
+    """printf formatting with the raw 32 bit words as arguments"""
+    values = []
+    for match in CONVERSION.finditer(fmt):
+        conv = match.group(1)
+        if conv == "%":
+            continue
+        raw = args[len(values)] if len(values) < len(args) else 0
+        if conv in "di":
+            values.append(raw - (1 << 32) if raw & 0x80000000 else raw)
+        elif conv in "sp":
+            values.append(f"<0x{raw:08x}>")
+        elif conv == "c":
+            values.append(chr(raw & 0xFF))
+        else:
+            values.append(raw)
+    return CONVERSION.sub(python_conversion, fmt) % tuple(values)
+
+
+def python_conversion(match):
+    """Python's % takes the same conversions, without C length modifiers"""
+    spec, conv = match.group(0)[:-1], match.group(1)
+    if conv == "%":
+        return "%%"
+    spec = re.sub(r"(hh|h|ll|l|z|t)$", "", spec)
+    return spec + {"s": "s", "p": "s", "i": "d"}.get(conv, conv)
+
+
+def records(stream):
+    """Yields (fmt address, ticks, args). Resyncs on the sync byte"""
+    buf = bytearray()
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            return
+        buf += chunk
+        while True:
+            start = buf.find(LOG_BIN_SYNC)
+            if start < 0:
+                buf.clear()
+                break
+            del buf[:start]
+            if len(buf) < 2:
+                break
+            length = buf[1]
+            if length % 4 or not 8 <= length <= 4 * (2 + LOG_BIN_MAX_ARGS):
+                del buf[:1]
+                continue
+            if len(buf) < 2 + length:
+                break
+            words = struct.unpack_from(f"<{length // 4}I", buf, 2)
+            del buf[:2 + length]
+            yield words[0], words[1], words[2:]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="firmware ELF the log came from")
+    parser.add_argument("input", nargs="?", help="serial device or capture file, default stdin")
+    parser.add_argument("--tick-hz", type=float, default=1000.0,
+                        help="configTICK_RATE_HZ of the build (default 1000)")
+    opts = parser.parse_args()
+
+    elf = Elf(opts.elf)
+    stream = open(opts.input, "rb", buffering=0) if opts.input else sys.stdin.buffer
+    try:
+        for addr, ticks, args in records(stream):
+            fmt = elf.string_at(addr)
+            if fmt is None:
+                text = f"<unknown format 0x{addr:08x}> {' '.join(f'0x{a:x}' for a in args)}\n"
+            else:
+                try:
+                    text = format_record(fmt, args)
+                except (TypeError, ValueError):
+                    text = f"<bad record for {fmt.strip()!r}>\n"
+            sys.stdout.write(f"[{ticks / opts.tick_hz:10.3f}] {text}")
+            sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()